@@ -0,0 +1,579 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL.h>
+#include "display.h"
+#include "sort.h"
+#include "raster.h"
+#include "tiles.h"
+#include "msaa.h"
+#include "bench.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Number of resolutions every primitive is measured at.
+ */
+#define BENCH_N_RESOLUTIONS 4
+
+/**
+ * @brief Number of primitives drawn between two clock reads, so reading the clock does not dominate.
+ */
+#define BENCH_BATCH 64
+
+/**
+ * @brief Color used by the benchmarks and the golden images.
+ */
+#define BENCH_COLOR 0xFF00FF00
+
+/**
+ * @brief Color the color buffer is cleared to before every golden image.
+ */
+#define BENCH_CLEAR_COLOR 0xFF000000
+
+/**
+ * @brief Longest path of a golden image.
+ */
+#define BENCH_MAX_PATH 512
+
+/**
+ * @brief Error message for when the offscreen color buffer cannot be allocated.
+ */
+#define BENCH_ALLOCATION_ERR "Error allocating the offscreen color buffer or its tiles.\n"
+
+/**
+ * @brief Error message for when a golden image cannot be read.
+ */
+#define BENCH_GOLDEN_READ_ERR "Error reading golden image %s.\n"
+
+/**
+ * @brief Error message for when a golden image cannot be written.
+ */
+#define BENCH_GOLDEN_WRITE_ERR "Error writing golden image %s.\n"
+#pragma endregion
+
+/**
+ * @brief Resolutions every primitive is measured at.
+ */
+static const int bench_resolutions[BENCH_N_RESOLUTIONS][2] = {
+    { 640, 480 },
+    { 1280, 720 },
+    { 1920, 1080 },
+    { 3840, 2160 }
+};
+
+/**
+ * @brief Triangle counts the sort is measured at.
+ */
+static const int bench_sort_sizes[] = { 10000, 1000000, 10000000 };
+
+/**
+ * @brief State of the pseudo random generator. Fixed seed, so every run draws the same primitives.
+ */
+static uint32_t bench_random_state = 1;
+
+/**
+ * @brief Triangles being sorted by the qsort comparator.
+ */
+static const triangle_t* qsort_triangles = NULL;
+
+/**
+ * @brief Small linear congruential generator, identical on every platform unlike rand().
+ */
+static uint32_t bench_random(void)
+{
+    bench_random_state = bench_random_state * 1664525u + 1013904223u;
+    return bench_random_state >> 8;
+}
+
+/**
+ * @brief Seconds elapsed since a performance counter value.
+ */
+static double seconds_since(const uint64_t start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+}
+
+/**
+ * @brief Resize the offscreen color buffer.
+ */
+static bool set_resolution(const int width, const int height)
+{
+    free(color_buffer);
+    color_buffer = (uint32_t*)malloc(sizeof(uint32_t) * width * height);
+
+    if (!color_buffer || !tiles_resize(width, height) || !msaa_resize(width, height))
+    {
+        int _ = fprintf(stderr, BENCH_ALLOCATION_ERR);
+        return false;
+    }
+
+    window_width = width;
+    window_height = height;
+    clear_color_buffer(BENCH_CLEAR_COLOR);
+
+    return true;
+}
+
+/**
+ * @brief Draw one batch of random rectangles and return the pixels covered.
+ */
+static double draw_rect_batch(void)
+{
+    const int size = window_height / 8;
+
+    for (int i = 0; i < BENCH_BATCH; i++)
+    {
+        // One random value per statement, the order of calls within an argument list is unspecified.
+        const float x = (float)(bench_random() % window_width);
+        const float y = (float)(bench_random() % window_height);
+        draw_rect(BENCH_COLOR, x, y, size, size);
+    }
+
+    return (double)BENCH_BATCH * size * size;
+}
+
+/**
+ * @brief Draw one batch of random lines and return the number of lines.
+ */
+static double draw_line_batch(void)
+{
+    for (int i = 0; i < BENCH_BATCH; i++)
+    {
+        vec2_t initial_point;
+        vec2_t target_point;
+        initial_point.x = (float)(bench_random() % window_width);
+        initial_point.y = (float)(bench_random() % window_height);
+        target_point.x = (float)(bench_random() % window_width);
+        target_point.y = (float)(bench_random() % window_height);
+        draw_line_DDA(BENCH_COLOR, initial_point, target_point);
+    }
+
+    return BENCH_BATCH;
+}
+
+/**
+ * @brief Draw one batch of random fixed point lines and return the number of lines.
+ */
+static double draw_line_fixed_batch(void)
+{
+    for (int i = 0; i < BENCH_BATCH; i++)
+    {
+        vec2_fixed_t initial_point;
+        vec2_fixed_t target_point;
+        initial_point.x = (int32_t)(bench_random() % ((uint32_t)window_width << SUBPIXEL_BITS));
+        initial_point.y = (int32_t)(bench_random() % ((uint32_t)window_height << SUBPIXEL_BITS));
+        target_point.x = (int32_t)(bench_random() % ((uint32_t)window_width << SUBPIXEL_BITS));
+        target_point.y = (int32_t)(bench_random() % ((uint32_t)window_height << SUBPIXEL_BITS));
+        draw_line_fixed(BENCH_COLOR, initial_point, target_point);
+    }
+
+    return BENCH_BATCH;
+}
+
+/**
+ * @brief Draw one batch of random pixels and return the number of pixels.
+ */
+static double draw_pixel_batch(void)
+{
+    for (int i = 0; i < BENCH_BATCH * 256; i++)
+    {
+        const int x = (int)(bench_random() % window_width);
+        const int y = (int)(bench_random() % window_height);
+        draw_pixel(BENCH_COLOR, x, y);
+    }
+
+    return BENCH_BATCH * 256.0;
+}
+
+/**
+ * @brief Clear the color buffer and return the number of pixels written.
+ */
+static double clear_batch(void)
+{
+    clear_color_buffer(BENCH_CLEAR_COLOR);
+    return (double)window_width * window_height;
+}
+
+/**
+ * @brief Draw the grid and return the number of pixels written.
+ */
+static double grid_batch(void)
+{
+    draw_grid(BENCH_COLOR);
+    return (double)((window_width + 9) / 10) * ((window_height + 9) / 10);
+}
+
+/**
+ * @brief Run a batch function repeatedly for at least BENCH_MIN_SECONDS and print its throughput.
+ */
+static void measure(const char* name, const char* unit, double (*batch)(void))
+{
+    double work = 0.0;
+    double elapsed = 0.0;
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    do
+    {
+        work += batch();
+        elapsed = seconds_since(start);
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    printf("%-20s %5dx%-5d %12.2f M%s/s\n", name, window_width, window_height, work / elapsed / 1e6, unit);
+}
+
+/**
+ * @brief Measure full update and draw frames and print the frame rate.
+ */
+static void measure_frames(const bench_frame_t* frame)
+{
+    int frames = 0;
+    double elapsed = 0.0;
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    frame->reset();
+
+    // The primitives drew without marking tiles, so the first clear has to cover the whole screen.
+    tiles_mark_all();
+
+    do
+    {
+        frame->clear();
+        frame->update();
+        frame->draw();
+        frames++;
+        elapsed = seconds_since(start);
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    printf("%-20s %5dx%-5d %12.2f frames/s %8.3f ms/frame\n", "frame", window_width, window_height,
+        frames / elapsed, 1000.0 * elapsed / frames);
+}
+
+/**
+ * @brief Order two triangle indices farthest first, ties by index so the result matches the stable radix sort.
+ */
+static int compare_depth_descending(const void* a, const void* b)
+{
+    const int index_a = *(const int*)a;
+    const int index_b = *(const int*)b;
+    const float depth_a = qsort_triangles[index_a].depth;
+    const float depth_b = qsort_triangles[index_b].depth;
+
+    if (depth_a != depth_b)
+    {
+        return (depth_a < depth_b) ? 1 : -1;
+    }
+
+    return (index_a > index_b) - (index_a < index_b);
+}
+
+/**
+ * @brief Time the radix sort against qsort on random depths.
+ */
+static void measure_sort(void)
+{
+    for (size_t s = 0; s < sizeof(bench_sort_sizes) / sizeof(bench_sort_sizes[0]); s++)
+    {
+        const int count = bench_sort_sizes[s];
+        triangle_t* triangles = (triangle_t*)malloc(sizeof(triangle_t) * count);
+        int* radix_order = (int*)malloc(sizeof(int) * count);
+        int* qsort_order = (int*)malloc(sizeof(int) * count);
+
+        if (!triangles || !radix_order || !qsort_order)
+        {
+            printf("%-20s %11d  skipped, out of memory\n", "sort", count);
+            free(triangles);
+            free(radix_order);
+            free(qsort_order);
+            continue;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            triangles[i].depth = 1.0f + (float)(bench_random() % 100000) * 0.001f;
+            qsort_order[i] = i;
+        }
+
+        uint64_t start = SDL_GetPerformanceCounter();
+        sort_triangles_back_to_front(triangles, count, radix_order);
+        const double radix_seconds = seconds_since(start);
+
+        qsort_triangles = triangles;
+        start = SDL_GetPerformanceCounter();
+        qsort(qsort_order, count, sizeof(int), compare_depth_descending);
+        const double qsort_seconds = seconds_since(start);
+
+        const bool same = memcmp(radix_order, qsort_order, sizeof(int) * count) == 0;
+
+        printf("%-20s %11d  radix %9.3f ms  qsort %9.3f ms  %6.1fx%s\n", "sort", count, radix_seconds * 1000.0,
+            qsort_seconds * 1000.0, qsort_seconds / radix_seconds, same ? "" : "  MISMATCH");
+
+        free(triangles);
+        free(radix_order);
+        free(qsort_order);
+    }
+}
+
+/**
+ * @brief Write the color buffer to a binary PPM file.
+ */
+static bool write_ppm(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+
+    if (!file)
+    {
+        return false;
+    }
+
+    int _ = fprintf(file, "P6\n%d %d\n255\n", window_width, window_height);
+
+    for (int i = 0; i < window_width * window_height; i++)
+    {
+        const uint8_t rgb[3] = {
+            (uint8_t)(color_buffer[i] >> 16),
+            (uint8_t)(color_buffer[i] >> 8),
+            (uint8_t)color_buffer[i]
+        };
+        _ = (int)fwrite(rgb, sizeof(rgb), 1, file);
+    }
+
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Compare the color buffer against a binary PPM file.
+ * @return The number of pixels outside the tolerance, or -1 if the file could not be read.
+ */
+static int compare_ppm(const char* path, const int tolerance)
+{
+    FILE* file = fopen(path, "rb");
+
+    if (!file)
+    {
+        return -1;
+    }
+
+    int width = 0;
+    int height = 0;
+    int max_value = 0;
+
+    if (fscanf(file, "P6 %d %d %d", &width, &height, &max_value) != 3 || fgetc(file) == EOF ||
+        width != window_width || height != window_height || max_value != 255)
+    {
+        int _ = fclose(file);
+        return -1;
+    }
+
+    int mismatches = 0;
+
+    for (int i = 0; i < width * height; i++)
+    {
+        uint8_t golden[3];
+
+        if (fread(golden, sizeof(golden), 1, file) != 1)
+        {
+            mismatches = -1;
+            break;
+        }
+
+        const int red = abs((int)((color_buffer[i] >> 16) & 0xFF) - golden[0]);
+        const int green = abs((int)((color_buffer[i] >> 8) & 0xFF) - golden[1]);
+        const int blue = abs((int)(color_buffer[i] & 0xFF) - golden[2]);
+
+        if (red > tolerance || green > tolerance || blue > tolerance)
+        {
+            mismatches++;
+        }
+    }
+
+    int _ = fclose(file);
+
+    return mismatches;
+}
+
+/**
+ * @brief Compare the color buffer against its golden image, or write it when updating.
+ * @return True if the image matched or was written.
+ */
+static bool check_golden(const bench_options_t* options, const char* name)
+{
+    char path[BENCH_MAX_PATH];
+    int _ = snprintf(path, sizeof(path), "%s/%s_%dx%d.ppm", options->golden_dir, name, window_width, window_height);
+
+    if (options->update_golden)
+    {
+        if (!write_ppm(path))
+        {
+            _ = fprintf(stderr, BENCH_GOLDEN_WRITE_ERR, path);
+            return false;
+        }
+
+        printf("%-20s written %s\n", name, path);
+        return true;
+    }
+
+    const int mismatches = compare_ppm(path, options->tolerance);
+
+    if (mismatches < 0)
+    {
+        _ = fprintf(stderr, BENCH_GOLDEN_READ_ERR, path);
+        return false;
+    }
+
+    printf("%-20s %s (%d pixels differ)\n", name, mismatches == 0 ? "ok" : "FAILED", mismatches);
+
+    return mismatches == 0;
+}
+
+/**
+ * @brief Draw a fixed scene for every primitive and check it against the golden images.
+ */
+static bool run_golden_images(const bench_options_t* options, const bench_frame_t* frame)
+{
+    bool passed = set_resolution(BENCH_GOLDEN_WIDTH, BENCH_GOLDEN_HEIGHT);
+
+    if (!passed)
+    {
+        return false;
+    }
+
+    bench_random_state = 1;
+    clear_color_buffer(BENCH_CLEAR_COLOR);
+    draw_grid(BENCH_COLOR);
+    passed = check_golden(options, "draw_grid") && passed;
+
+    clear_color_buffer(BENCH_CLEAR_COLOR);
+    draw_rect_batch();
+    passed = check_golden(options, "draw_rect") && passed;
+
+    clear_color_buffer(BENCH_CLEAR_COLOR);
+    draw_line_batch();
+    passed = check_golden(options, "draw_line_DDA") && passed;
+
+    clear_color_buffer(BENCH_CLEAR_COLOR);
+    draw_line_fixed_batch();
+    passed = check_golden(options, "draw_line_fixed") && passed;
+
+    frame->reset();
+    tiles_mark_all();
+
+    for (int i = 0; i < BENCH_GOLDEN_FRAMES; i++)
+    {
+        frame->clear();
+        frame->update();
+        frame->draw();
+    }
+
+    passed = check_golden(options, "frame") && passed;
+
+    return passed;
+}
+
+bool parse_bench_options(const int argc, char* argv[], bench_options_t* options)
+{
+    options->enabled = false;
+    options->golden_dir = BENCH_DEFAULT_GOLDEN_DIR;
+    options->update_golden = false;
+    options->tolerance = BENCH_DEFAULT_TOLERANCE;
+    options->sort = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            options->enabled = true;
+        }
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+        {
+            options->golden_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--no-golden") == 0)
+        {
+            options->golden_dir = NULL;
+        }
+        else if (strcmp(argv[i], "--update-golden") == 0)
+        {
+            options->update_golden = true;
+        }
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+        {
+            options->tolerance = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bench-sort") == 0)
+        {
+            options->sort = true;
+        }
+    }
+
+    return options->enabled;
+}
+
+int run_benchmarks(const bench_options_t* options, const bench_frame_t* frame)
+{
+    bool passed = true;
+
+    printf("raster kernels: %s\n", raster_kernels.isa_name);
+
+    for (int r = 0; r < BENCH_N_RESOLUTIONS; r++)
+    {
+        if (!set_resolution(bench_resolutions[r][0], bench_resolutions[r][1]))
+        {
+            return 1;
+        }
+
+        measure("clear_color_buffer", "pixels", clear_batch);
+        measure("draw_pixel", "pixels", draw_pixel_batch);
+        measure("draw_grid", "pixels", grid_batch);
+        measure("draw_rect", "pixels", draw_rect_batch);
+        measure("draw_line_DDA", "lines", draw_line_batch);
+        measure("draw_line_fixed", "lines", draw_line_fixed_batch);
+        measure_frames(frame);
+    }
+
+    if (options->sort)
+    {
+        measure_sort();
+    }
+
+    if (options->golden_dir)
+    {
+        passed = run_golden_images(options, frame);
+    }
+
+    free(color_buffer);
+    color_buffer = NULL;
+
+    return passed ? 0 : 1;
+}
+
+int run_scripted_benchmark(const replay_options_t* options, const bench_frame_t* frame)
+{
+    printf("raster kernels: %s\n", raster_kernels.isa_name);
+
+    if (!set_resolution(options->width, options->height))
+    {
+        return 1;
+    }
+
+    const int frames = replay_frame_count();
+
+    frame->reset();
+    tiles_mark_all();
+
+    for (int i = 0; i < frames; i++)
+    {
+        const uint64_t start = SDL_GetPerformanceCounter();
+        frame->clear();
+        frame->update();
+        frame->draw();
+        replay_time_frame(1000.0 * seconds_since(start));
+    }
+
+    const bool reported = replay_report(options);
+
+    free(color_buffer);
+    color_buffer = NULL;
+
+    return reported ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include "replay.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Shortest time in seconds a single measurement runs for.
+ */
+#define BENCH_MIN_SECONDS 0.25
+
+/**
+ * @brief Default per channel difference allowed between a rendered image and its golden image.
+ */
+#define BENCH_DEFAULT_TOLERANCE 8
+
+/**
+ * @brief Directory of the golden images checked into the repository, relative to the repository root.
+ */
+#define BENCH_DEFAULT_GOLDEN_DIR "Engine/Engine/golden"
+
+/**
+ * @brief Width of the images compared against golden images.
+ */
+#define BENCH_GOLDEN_WIDTH 320
+
+/**
+ * @brief Height of the images compared against golden images.
+ */
+#define BENCH_GOLDEN_HEIGHT 240
+
+/**
+ * @brief Number of frames simulated before the full frame golden image is captured.
+ */
+#define BENCH_GOLDEN_FRAMES 30
+#pragma endregion
+
+/**
+ * @brief Options of a headless benchmark run, parsed from the command line.
+ */
+typedef struct
+{
+    /**
+     * @brief Run the benchmarks. Set by --benchmark.
+     */
+    bool enabled;
+    /**
+     * @brief Directory holding the golden images, or NULL to skip the comparison. BENCH_DEFAULT_GOLDEN_DIR unless set
+     * by --golden <dir>, or NULL with --no-golden.
+     */
+    const char* golden_dir;
+    /**
+     * @brief Write the golden images instead of comparing against them. Set by --update-golden.
+     */
+    bool update_golden;
+    /**
+     * @brief Per channel difference allowed before a pixel counts as different. Set by --tolerance <n>.
+     */
+    int tolerance;
+    /**
+     * @brief Also time the triangle sort against qsort. Set by --bench-sort.
+     */
+    bool sort;
+} bench_options_t;
+
+/**
+ * @brief The hooks the benchmark uses to drive the application's frame.
+ */
+typedef struct
+{
+    /**
+     * @brief Put the scene back in its initial state.
+     */
+    void (*reset)(void);
+    /**
+     * @brief Restore the background under what the previous frame drew.
+     */
+    void (*clear)(void);
+    /**
+     * @brief Advance the scene by one frame and emit the triangles to render.
+     */
+    void (*update)(void);
+    /**
+     * @brief Draw the emitted triangles into the color buffer.
+     */
+    void (*draw)(void);
+} bench_frame_t;
+
+/**
+ * @brief Parse the benchmark options out of the command line.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @param options Receives the options.
+ * @return True if a benchmark run was requested.
+ */
+bool parse_bench_options(const int argc, char* argv[], bench_options_t* options);
+
+/**
+ * @brief Run the display primitive and full frame benchmarks into an offscreen color buffer, then compare or update
+ * the golden images. No window is created.
+ * @param options The benchmark options.
+ * @param frame The hooks used to drive full frames.
+ * @return 0 if every image matched its golden image, 1 otherwise.
+ */
+int run_benchmarks(const bench_options_t* options, const bench_frame_t* frame);
+
+/**
+ * @brief Play the loaded script headless, one frame per script frame, and report the time of every frame. No window
+ * is created.
+ * @param options The scripted run options, for the resolution and the timing files.
+ * @param frame The hooks used to drive the frames.
+ * @return 0 if the timings were reported, 1 otherwise.
+ */
+int run_scripted_benchmark(const replay_options_t* options, const bench_frame_t* frame);
+
+#endif
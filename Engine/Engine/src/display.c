@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #include <math.h>
 #include "display.h"
+#include "msaa.h"
+#include "raster.h"
+#include "tiles.h"
 
 #pragma region Preprocessor directives
 /**
@@ -18,8 +21,27 @@
  * @brief Error message for when the SDL renderer cannot be created.
  */
 #define SDL_RENDERER_CREATE_ERR "Error creating the SDL renderer.\n"
+/**
+ * @brief Error message for when the color buffer texture cannot be updated.
+ */
+#define SDL_TEXTURE_UPDATE_ERR "Error occured while updating texture: %d.\n"
 #pragma endregion 
 
+/**
+ * @brief The background restored by clear_drawn_tiles().
+ */
+typedef struct
+{
+	/**
+	 * @brief The clear color.
+	 */
+	uint32_t color;
+	/**
+	 * @brief The grid color.
+	 */
+	uint32_t grid_color;
+} background_t;
+
 #pragma region Global variables
 /// <summary>
 /// Pointer to the SDL window data that will be used throughout the application.
@@ -50,6 +72,11 @@ int window_width;
 /// The window height in pixels.
 /// </summary>
 int window_height;
+
+/// <summary>
+/// Whether the color buffer is cleared and uploaded per tile.
+/// </summary>
+bool tiles_enabled = true;
 #pragma endregion
 
 
@@ -112,59 +139,95 @@ bool initialize_window(void)
 }
 
 /**
- * @brief Render the color buffer.
+ * @brief Upload one run of tiles to the color buffer texture.
  */
-void render_color_buffer(void)
+static void upload_tile_run(const tile_run_t* run, void* data)
 {
-	int res = SDL_UpdateTexture(
+	const SDL_Rect rect = { run->x, run->y, run->width, run->height };
+
+	const int res = SDL_UpdateTexture(
 		color_buffer_texture,
-		NULL,
-		color_buffer,
+		&rect,
+		&color_buffer[(window_width * run->y) + run->x],
 		(int)window_width * sizeof(uint32_t)
 	);
 
 	if (res < 0)
 	{
-		int _ = fprintf(stderr, "Error occured while updating texture: %d.\n", SDL_Error(res));
+		int _ = fprintf(stderr, SDL_TEXTURE_UPDATE_ERR, SDL_Error(res));
 	}
+}
 
-	res = SDL_RenderCopy(renderer, color_buffer_texture, NULL, NULL);
+/**
+ * @brief Render the color buffer.
+ */
+void render_color_buffer(void)
+{
+	const int upload_mask = TILE_DRAWN | TILE_DRAWN_PREVIOUS;
+
+	// Tiles drawn last frame still show it and need this frame's background. When everything changed a single upload
+	// is cheaper than one per run.
+	if (!tiles_enabled || tiles_count_marked(upload_mask) == tiles_count())
+	{
+		const tile_run_t screen = { 0, 0, window_width, window_height };
+		upload_tile_run(&screen, NULL);
+	}
+	else
+	{
+		tiles_for_each_run(upload_mask, upload_tile_run, NULL);
+	}
+
+	const int res = SDL_RenderCopy(renderer, color_buffer_texture, NULL, NULL);
 
 	if (res < 0)
 	{
-		int _ = fprintf(stderr, "Error occured while updating texture: %d.\n", SDL_Error(res));
+		int _ = fprintf(stderr, SDL_TEXTURE_UPDATE_ERR, SDL_Error(res));
 	}
 }
 
 /**
- * @brief Clear the color buffer with a specified color.
- * @param color An ARGB color value.
+ * @brief Restore the background of one run of tiles.
  */
-void clear_color_buffer(const uint32_t color)
+static void clear_tile_run(const tile_run_t* run, void* data)
 {
-	// int y = 0;
-	// int x = 0;
+	const background_t* background = (const background_t*)data;
 
-	// // Optimized loop... but it's slower.
-	// for (int i = 0; i < window_width * window_height; i++, y = (i / window_width), x = (i % window_width))
-	// {
-	// 	// Set the pixel color.
-	// 	color_buffer[(y * window_width) + x] = color;
-	// }
+	// First grid column inside the run.
+	const int grid_x = ((run->x + GRID_SPACING - 1) / GRID_SPACING) * GRID_SPACING;
 
-	// Slow solution... but it's faster???
-	for (int y = 0; y < window_height; y++)
+	for (int y = run->y; y < run->y + run->height; y++)
 	{
-		for (int x = 0; x < window_width; x++)
+		uint32_t* row = &color_buffer[window_width * y];
+		raster_kernels.fill_span(row + run->x, (size_t)run->width, background->color);
+
+		if (y % GRID_SPACING == 0)
 		{
-			// We traverse to each row (the row is incremented by the value of y)
-			// and across it (position within the row determined by the value of x)
-			// and set the color of that pixel.
-			color_buffer[(window_width * y) + x] = color;
+			for (int x = grid_x; x < run->x + run->width; x += GRID_SPACING)
+			{
+				row[x] = background->grid_color;
+			}
 		}
 	}
 }
 
+void clear_drawn_tiles(const uint32_t color, const uint32_t grid_color)
+{
+	background_t background = { color, grid_color };
+
+	tiles_for_each_run(TILE_DRAWN, clear_tile_run, &background);
+	tiles_next_frame();
+}
+
+/**
+ * @brief Clear the color buffer with a specified color.
+ * @param color An ARGB color value.
+ */
+void clear_color_buffer(const uint32_t color)
+{
+	// The buffer is one contiguous run of pixels, so it can be filled as a single span.
+	raster_kernels.fill_span(color_buffer, (size_t)window_width * window_height, color);
+}
+
 /**
  * @brief Draw a pixel to the screen.
  * @param x X position to draw.
@@ -176,6 +239,7 @@ void draw_pixel(const uint32_t color, const int x, const int y)
 	if (x >= 0 && x < window_width && y >= 0 && y < window_height)
 	{
 		color_buffer[(window_width * y) + x] = color;
+		msaa_flatten_span(((size_t)window_width * y) + x, 1);
 	}
 }
 
@@ -185,9 +249,9 @@ void draw_pixel(const uint32_t color, const int x, const int y)
  */
 void draw_grid(const uint32_t color)
 {
-	for (int y = 0; y < window_height; y += 10)
+	for (int y = 0; y < window_height; y += GRID_SPACING)
 	{
-		for (int x = 0; x < window_width; x += 10)
+		for (int x = 0; x < window_width; x += GRID_SPACING)
 		{
 			color_buffer[(window_width * y) + x] = color;
 		}
@@ -204,17 +268,31 @@ void draw_grid(const uint32_t color)
  */
 void draw_rect(const uint32_t color, const float loc_x, const float loc_y, const int width, const int height)
 {
-	for (int i = 0; i < width; i++)
+	if (width <= 0 || height <= 0)
 	{
-		for (int j = 0; j < height; j++)
-		{
-			// Calculate the current x and y.
-			const int current_x = (int)(loc_x + (float)i);
-			const int current_y = (int)(loc_y + (float)j);
-			
-			// Draw the pixel.
-			draw_pixel(color, current_x, current_y);
-		}
+		return;
+	}
+
+	// The pixels covered by each row and column, clipped to the screen.
+	int first_x = (int)loc_x;
+	int last_x = (int)(loc_x + (float)(width - 1));
+	int first_y = (int)loc_y;
+	int last_y = (int)(loc_y + (float)(height - 1));
+
+	first_x = (first_x < 0) ? 0 : first_x;
+	first_y = (first_y < 0) ? 0 : first_y;
+	last_x = (last_x > window_width - 1) ? window_width - 1 : last_x;
+	last_y = (last_y > window_height - 1) ? window_height - 1 : last_y;
+
+	if (first_x > last_x)
+	{
+		return;
+	}
+
+	for (int y = first_y; y <= last_y; y++)
+	{
+		raster_kernels.fill_span(&color_buffer[(window_width * y) + first_x], (size_t)(last_x - first_x + 1), color);
+		msaa_flatten_span(((size_t)window_width * y) + first_x, (size_t)(last_x - first_x + 1));
 	}
 }
 
@@ -246,6 +324,114 @@ void draw_line_DDA(const uint32_t color, const vec2_t initial_point, const vec2_
 	}
 }
 
+/**
+ * @brief Divide, rounding towards negative infinity.
+ */
+static int64_t floor_div(const int64_t numerator, const int64_t denominator)
+{
+	const int64_t quotient = numerator / denominator;
+
+	return ((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0))) ? quotient - 1 : quotient;
+}
+
+/**
+ * @brief Narrow the steps of a line to the ones whose exact position on one axis lies within [-1, limit]. A pixel
+ * drawn by Bresenham's algorithm is never more than half a pixel off the exact line, so this keeps every step whose
+ * pixel is on screen.
+ * @param start The coordinate of the first pixel on the axis.
+ * @param delta The signed distance to the last pixel on the axis.
+ * @param steps The number of steps of the whole line, at least 1.
+ * @param limit The size of the screen on the axis.
+ * @param first_step The first step to draw, raised in place.
+ * @param last_step The last step to draw, lowered in place.
+ */
+static void clip_line_steps(const int64_t start, const int64_t delta, const int64_t steps, const int limit,
+	int64_t* first_step, int64_t* last_step)
+{
+	// At step k the exact coordinate is start + delta * k / steps.
+	const int64_t low = (-1 - start) * steps;
+	const int64_t high = (limit - start) * steps;
+
+	if (delta == 0)
+	{
+		if (low > 0 || high < 0)
+		{
+			*last_step = -1;
+		}
+
+		return;
+	}
+
+	// Round outwards, a step too many is caught by draw_pixel().
+	const int64_t first = (delta > 0) ? floor_div(low, delta) : floor_div(high, delta);
+	const int64_t last = (delta > 0) ? -floor_div(-high, delta) : -floor_div(-low, delta);
+
+	*first_step = (first > *first_step) ? first : *first_step;
+	*last_step = (last < *last_step) ? last : *last_step;
+}
+
+void draw_line_fixed(const uint32_t color, const vec2_fixed_t initial_point, const vec2_fixed_t target_point)
+{
+	// Bresenham's algorithm between the pixels nearest to the two points.
+	const int start_x = fixed_to_pixel(initial_point.x);
+	const int start_y = fixed_to_pixel(initial_point.y);
+	const int target_x = fixed_to_pixel(target_point.x);
+	const int target_y = fixed_to_pixel(target_point.y);
+
+	const int delta_x = abs(target_x - start_x);
+	const int delta_y = -abs(target_y - start_y);
+	const int step_x = (start_x < target_x) ? 1 : -1;
+	const int step_y = (start_y < target_y) ? 1 : -1;
+	const bool x_major = delta_x >= -delta_y;
+	const int64_t steps = x_major ? delta_x : -delta_y;
+
+	if (steps == 0)
+	{
+		draw_pixel(color, start_x, start_y);
+		return;
+	}
+
+	// End points may lie anywhere in the guard band, so only step through the part of the line on screen.
+	int64_t first_step = 0;
+	int64_t last_step = steps;
+	clip_line_steps(start_x, (int64_t)target_x - start_x, steps, window_width, &first_step, &last_step);
+	clip_line_steps(start_y, (int64_t)target_y - start_y, steps, window_height, &first_step, &last_step);
+
+	if (first_step > last_step)
+	{
+		return;
+	}
+
+	// Skip ahead to the first step: the major axis moves every step, the minor axis once for every time the error
+	// crossed half a pixel, which is the rounded position of the exact line.
+	const int64_t major = x_major ? delta_x : -delta_y;
+	const int64_t minor = x_major ? -delta_y : delta_x;
+	const int64_t minor_steps = ((2 * first_step * minor) + major) / (2 * major);
+	int x = start_x + (int)((x_major ? first_step : minor_steps) * step_x);
+	int y = start_y + (int)((x_major ? minor_steps : first_step) * step_y);
+	int error = (int)(x_major ? (delta_x + delta_y) + (first_step * delta_y) + (minor_steps * delta_x) :
+		(delta_x + delta_y) + (first_step * delta_x) + (minor_steps * delta_y));
+
+	for (int64_t i = first_step; i <= last_step; i++)
+	{
+		draw_pixel(color, x, y);
+
+		const int doubled_error = 2 * error;
+
+		if (doubled_error >= delta_y)
+		{
+			error += delta_y;
+			x += step_x;
+		}
+
+		if (doubled_error <= delta_x)
+		{
+			error += delta_x;
+			y += step_y;
+		}
+	}
+}
+
 void destroy_window(void)
 {
 	free(color_buffer);
@@ -16,6 +16,11 @@
  * @brief The time between frames.
  */
 #define FRAME_TARGET_TIME (1000 / FPS)
+
+/**
+ * @brief Distance in pixels between two points of the grid.
+ */
+#define GRID_SPACING 10
 #pragma endregion
 
 #pragma region Global variables
@@ -53,6 +58,12 @@ extern int window_width;
 /// The window height in pixels.
 /// </summary>
 extern int window_height;
+
+/// <summary>
+/// Whether the color buffer is cleared and uploaded per tile. False when the tile grid could not be allocated, then
+/// every frame is cleared and uploaded whole.
+/// </summary>
+extern bool tiles_enabled;
 #pragma endregion
 
 #pragma region Function definitions
@@ -63,10 +74,19 @@ extern int window_height;
 bool initialize_window(void);
 
 /**
- * @brief Setup the color buffer.
+ * @brief Upload the tiles drawn this frame or last frame to the color buffer texture, or all of it without tiles, and
+ * copy it to the renderer.
  */
 void render_color_buffer(void);
 
+/**
+ * @brief Restore the background, the clear color and the grid, in the tiles drawn this frame, then move the tile
+ * tracking on to the next frame.
+ * @param color An ARGB color value to clear to.
+ * @param grid_color An ARGB color value for the grid.
+ */
+void clear_drawn_tiles(const uint32_t color, const uint32_t grid_color);
+
 /**
  * @brief Clear the color buffer with a specified color.
  * @param color An ARGB color value.
@@ -105,6 +125,15 @@ void draw_rect(const uint32_t color, const float loc_x, const float loc_y, const
  */
 void draw_line_DDA(const uint32_t color, const vec2_t initial_point, const vec2_t target_point);
 
+/**
+ * @brief Draw a line between two fixed point screen positions using only integer math. Only the part of the line on
+ * screen is stepped through.
+ * @param color An ARGB color value.
+ * @param initial_point The starting point from which to begin drawing the line.
+ * @param target_point The target point to draw the line to.
+ */
+void draw_line_fixed(const uint32_t color, const vec2_fixed_t initial_point, const vec2_fixed_t target_point);
+
 /**
  * @brief Release allocated resources.
  */
@@ -0,0 +1,19 @@
+#include "light.h"
+
+light_t light = {
+    .direction = { .x = 0, .y = 0, .z = 1 }
+};
+
+int light_level_from_normal(const vec3_t normal)
+{
+    // Faces pointing against the light direction receive the most light.
+    const float intensity = -vec3_dot(normal, light.direction);
+    const int level = LIGHT_AMBIENT_LEVEL + (int)(intensity * (float)(LIGHT_LEVEL_MAX - LIGHT_AMBIENT_LEVEL));
+
+    if (level < LIGHT_AMBIENT_LEVEL)
+    {
+        return LIGHT_AMBIENT_LEVEL;
+    }
+
+    return (level > LIGHT_LEVEL_MAX) ? LIGHT_LEVEL_MAX : level;
+}
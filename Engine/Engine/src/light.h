@@ -0,0 +1,62 @@
+#ifndef LIGHT_H
+#define LIGHT_H
+
+#include <stdint.h>
+#include "vector.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Number of fractional bits in a light level.
+ */
+#define LIGHT_LEVEL_SHIFT 8
+
+/**
+ * @brief The light level of a fully lit surface. Light levels range from 0 to LIGHT_LEVEL_MAX inclusive.
+ */
+#define LIGHT_LEVEL_MAX (1 << LIGHT_LEVEL_SHIFT)
+
+/**
+ * @brief The light level of a surface facing away from the light, so unlit faces are not pitch black.
+ */
+#define LIGHT_AMBIENT_LEVEL (LIGHT_LEVEL_MAX / 8)
+#pragma endregion
+
+/**
+ * @brief A directional light.
+ */
+typedef struct
+{
+    /**
+     * @brief The unit direction the light travels in.
+     */
+    vec3_t direction;
+} light_t;
+
+/**
+ * @brief The light illuminating the scene.
+ */
+extern light_t light;
+
+/**
+ * @brief Compute the flat shading light level of a face.
+ * @param normal The unit normal of the face in the same space as the light.
+ * @return A light level between LIGHT_AMBIENT_LEVEL and LIGHT_LEVEL_MAX.
+ */
+int light_level_from_normal(const vec3_t normal);
+
+/**
+ * @brief Scale the red, green and blue channels of a color by a light level. Alpha is left untouched.
+ * @param color An ARGB color value.
+ * @param level A light level between 0 and LIGHT_LEVEL_MAX.
+ * @return The shaded ARGB color value.
+ */
+static inline uint32_t light_apply_level(const uint32_t color, const int level)
+{
+    // Red and blue are 16 bits apart, so both fit in one multiply without spilling into each other.
+    const uint32_t red_blue = (((color & 0x00FF00FF) * (uint32_t)level) >> LIGHT_LEVEL_SHIFT) & 0x00FF00FF;
+    const uint32_t green = (((color & 0x0000FF00) * (uint32_t)level) >> LIGHT_LEVEL_SHIFT) & 0x0000FF00;
+
+    return (color & 0xFF000000) | red_blue | green;
+}
+
+#endif
@@ -0,0 +1,384 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL.h>
+#include "../include/array.h"
+#include "loader.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief The loader thread is parsing the file.
+ */
+#define LOADER_STATE_RUNNING 0
+
+/**
+ * @brief The loader thread published every chunk of the file.
+ */
+#define LOADER_STATE_DONE 1
+
+/**
+ * @brief The loader thread stopped before the end of the file.
+ */
+#define LOADER_STATE_FAILED 2
+
+/**
+ * @brief Error message for when the loader thread cannot be started.
+ */
+#define LOADER_THREAD_ERR "Error starting the mesh loader thread.\n"
+
+/**
+ * @brief Error message for when an OBJ file cannot be opened.
+ */
+#define LOADER_OPEN_ERR "Error opening OBJ file %s.\n"
+#pragma endregion
+
+/**
+ * @brief The running loader thread, or NULL.
+ */
+static SDL_Thread* loader_thread = NULL;
+
+/**
+ * @brief Copy of the path of the file being loaded.
+ */
+static char* loader_filename = NULL;
+
+/**
+ * @brief Single producer, single consumer queue of published chunks, each the quantized vertices and faces parsed
+ * since the previous one. Slots between tail and head are owned by the render side, every other slot by the loader
+ * thread.
+ */
+static mesh_quantized_t* chunk_queue[LOADER_QUEUE_SIZE];
+
+/**
+ * @brief Number of chunks published so far. Only written by the loader thread.
+ */
+static SDL_atomic_t queue_head = { 0 };
+
+/**
+ * @brief Number of chunks uploaded so far. Only written by the render side.
+ */
+static SDL_atomic_t queue_tail = { 0 };
+
+/**
+ * @brief One of the LOADER_STATE values.
+ */
+static SDL_atomic_t loader_state = { LOADER_STATE_DONE };
+
+/**
+ * @brief Set by the render side to ask the loader thread to stop.
+ */
+static SDL_atomic_t loader_cancelled = { 0 };
+
+/**
+ * @brief The quantized mesh being assembled from uploaded chunks. Only touched by the render side.
+ */
+static mesh_quantized_t staging_mesh = { 0 };
+
+/**
+ * @brief Append the items of one dynamic array to another.
+ * @return The target array, which may have moved.
+ */
+static void* append_array(void* target, const void* source, const int item_size)
+{
+    const int count = array_length((void*)source);
+
+    if (count == 0)
+    {
+        return target;
+    }
+
+    const int offset = array_length(target);
+    target = array_hold(target, count, item_size);
+    memcpy((char*)target + ((size_t)offset * item_size), source, (size_t)count * item_size);
+
+    return target;
+}
+
+/**
+ * @brief Release a chunk and everything it holds.
+ */
+static void free_chunk(mesh_quantized_t* chunk)
+{
+    free_quantized_mesh(chunk);
+    free(chunk);
+}
+
+/**
+ * @brief Hand a quantized chunk over to the render side.
+ * @return False if the load was cancelled while waiting for room in the queue.
+ */
+static bool publish_chunk(mesh_quantized_t* chunk)
+{
+    const int head = SDL_AtomicGet(&queue_head);
+
+    // Wait for the render side to make room.
+    while (head - SDL_AtomicGet(&queue_tail) >= LOADER_QUEUE_SIZE)
+    {
+        if (SDL_AtomicGet(&loader_cancelled))
+        {
+            free_chunk(chunk);
+            return false;
+        }
+
+        SDL_Delay(1);
+    }
+
+    chunk_queue[head & (LOADER_QUEUE_SIZE - 1)] = chunk;
+
+    // Atomic sets are full barriers, so the chunk is visible before the new head is.
+    SDL_AtomicSet(&queue_head, head + 1);
+
+    return true;
+}
+
+/**
+ * @brief Read the bounds and the vertex count of the whole file, which every chunk is quantized against.
+ * @return False if the load was cancelled.
+ */
+static bool scan_mesh_bounds(FILE* file, mesh_bounds_t* bounds)
+{
+    obj_parser_t parser = { 0 };
+    char line[OBJ_MAX_LINE_LENGTH];
+    int lines_in_chunk = 0;
+    bool cancelled = false;
+
+    while (!cancelled && fgets(line, OBJ_MAX_LINE_LENGTH, file))
+    {
+        // Only vertices matter here, faces would reference texture coordinates this pass does not keep.
+        if (strncmp(line, "v ", 2) == 0)
+        {
+            obj_parse_line(&parser, line);
+        }
+
+        if (++lines_in_chunk == LOADER_CHUNK_LINES)
+        {
+            lines_in_chunk = 0;
+            extend_mesh_bounds(bounds, parser.vertices);
+            array_free(parser.vertices);
+            parser.vertices = NULL;
+            cancelled = SDL_AtomicGet(&loader_cancelled);
+        }
+    }
+
+    extend_mesh_bounds(bounds, parser.vertices);
+    free_obj_parser(&parser);
+
+    return !cancelled;
+}
+
+/**
+ * @brief Compute the normals of the vertices and faces parsed since the last chunk, quantize them and publish them.
+ * @param parser The parser, whose vertices and faces are taken.
+ * @param vertices Every vertex parsed so far in float form, which the normals of later faces need. Extended.
+ * @param quantizer The quantizer of the whole mesh.
+ * @return False if the load was cancelled or ran out of memory.
+ */
+static bool publish_parsed_chunk(obj_parser_t* parser, vec3_t** vertices, const mesh_quantizer_t* quantizer)
+{
+    if (!parser->vertices && !parser->faces)
+    {
+        return true;
+    }
+
+    mesh_quantized_t* chunk = (mesh_quantized_t*)calloc(1, sizeof(mesh_quantized_t));
+
+    if (!chunk)
+    {
+        return false;
+    }
+
+    // Faces index into every vertex of the file, not just the ones of this chunk.
+    *vertices = append_array(*vertices, parser->vertices, sizeof(vec3_t));
+    mesh_t part = {
+        .vertices = *vertices,
+        .faces = parser->faces,
+        .normals = NULL
+    };
+    compute_mesh_normals(&part);
+    quantize_mesh_part(chunk, quantizer, parser->vertices, parser->faces, part.normals);
+
+    array_free(part.normals);
+    array_free(parser->vertices);
+    array_free(parser->faces);
+    parser->vertices = NULL;
+    parser->faces = NULL;
+
+    return publish_chunk(chunk);
+}
+
+/**
+ * @brief Entry point of the loader thread. Reads the bounds of the file, then parses, quantizes and publishes it
+ * chunk by chunk, so the render side only copies packed arrays.
+ */
+static int loader_thread_main(void* data)
+{
+    FILE* file = fopen(loader_filename, "r");
+
+    if (!file)
+    {
+        int _ = fprintf(stderr, LOADER_OPEN_ERR, loader_filename);
+        SDL_AtomicSet(&loader_state, LOADER_STATE_FAILED);
+        return 1;
+    }
+
+    mesh_bounds_t bounds = { 0 };
+    bool published = scan_mesh_bounds(file, &bounds);
+    const mesh_quantizer_t quantizer = make_mesh_quantizer(&bounds);
+    rewind(file);
+
+    obj_parser_t parser = { 0 };
+    vec3_t* vertices = NULL;
+    char line[OBJ_MAX_LINE_LENGTH];
+    int lines_in_chunk = 0;
+
+    while (published && fgets(line, OBJ_MAX_LINE_LENGTH, file))
+    {
+        obj_parse_line(&parser, line);
+
+        if (++lines_in_chunk == LOADER_CHUNK_LINES)
+        {
+            lines_in_chunk = 0;
+            published = !SDL_AtomicGet(&loader_cancelled) && publish_parsed_chunk(&parser, &vertices, &quantizer);
+        }
+    }
+
+    published = published && publish_parsed_chunk(&parser, &vertices, &quantizer);
+
+    int _ = fclose(file);
+    free_obj_parser(&parser);
+    array_free(vertices);
+
+    SDL_AtomicSet(&loader_state, published ? LOADER_STATE_DONE : LOADER_STATE_FAILED);
+
+    return published ? 0 : 1;
+}
+
+/**
+ * @brief Release the chunks waiting in the queue.
+ */
+static void free_queued_chunks(void)
+{
+    const int head = SDL_AtomicGet(&queue_head);
+
+    for (int tail = SDL_AtomicGet(&queue_tail); tail != head; tail++)
+    {
+        free_chunk(chunk_queue[tail & (LOADER_QUEUE_SIZE - 1)]);
+    }
+
+    SDL_AtomicSet(&queue_head, 0);
+    SDL_AtomicSet(&queue_tail, 0);
+}
+
+bool load_obj_file_async(const char* filename)
+{
+    // Only one file at a time.
+    if (loader_thread)
+    {
+        return false;
+    }
+
+    loader_filename = (char*)malloc(strlen(filename) + 1);
+
+    if (!loader_filename)
+    {
+        return false;
+    }
+
+    strcpy(loader_filename, filename);
+
+    SDL_AtomicSet(&queue_head, 0);
+    SDL_AtomicSet(&queue_tail, 0);
+    SDL_AtomicSet(&loader_cancelled, 0);
+    SDL_AtomicSet(&loader_state, LOADER_STATE_RUNNING);
+
+    loader_thread = SDL_CreateThread(loader_thread_main, "mesh_loader", NULL);
+
+    if (!loader_thread)
+    {
+        int _ = fprintf(stderr, LOADER_THREAD_ERR);
+        SDL_AtomicSet(&loader_state, LOADER_STATE_FAILED);
+        free(loader_filename);
+        loader_filename = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+bool upload_loaded_mesh_chunks(void)
+{
+    if (!loader_thread)
+    {
+        return false;
+    }
+
+    // Read the state before the head. If the loader was done by then, the head already counts its last chunk.
+    const int state = SDL_AtomicGet(&loader_state);
+    const int head = SDL_AtomicGet(&queue_head);
+    const uint32_t start_time = SDL_GetTicks();
+    int tail = SDL_AtomicGet(&queue_tail);
+
+    // Upload at least one chunk per frame so a slow frame cannot stall the load.
+    while (tail != head)
+    {
+        mesh_quantized_t* chunk = chunk_queue[tail & (LOADER_QUEUE_SIZE - 1)];
+
+        // Chunks are already quantized, uploading them is only copying.
+        staging_mesh.dequantize = chunk->dequantize;
+        staging_mesh.positions = append_array(staging_mesh.positions, chunk->positions, sizeof(vec3_quantized_t));
+        staging_mesh.short_indices = append_array(staging_mesh.short_indices, chunk->short_indices, sizeof(uint16_t));
+        staging_mesh.long_indices = append_array(staging_mesh.long_indices, chunk->long_indices, sizeof(uint32_t));
+        staging_mesh.texcoords = append_array(staging_mesh.texcoords, chunk->texcoords, sizeof(tex2_packed_t));
+        staging_mesh.texcoord_bits = append_array(staging_mesh.texcoord_bits, chunk->texcoord_bits, sizeof(uint8_t));
+        staging_mesh.normals = append_array(staging_mesh.normals, chunk->normals, sizeof(normal_packed_t));
+        free_chunk(chunk);
+
+        // Give the slot back to the loader thread.
+        SDL_AtomicSet(&queue_tail, ++tail);
+
+        if (SDL_GetTicks() - start_time >= LOADER_UPLOAD_BUDGET_MS)
+        {
+            break;
+        }
+    }
+
+    if (tail != head || state == LOADER_STATE_RUNNING)
+    {
+        return false;
+    }
+
+    // Everything the loader produced has been uploaded.
+    SDL_WaitThread(loader_thread, NULL);
+    loader_thread = NULL;
+    free(loader_filename);
+    loader_filename = NULL;
+
+    if (state == LOADER_STATE_FAILED || array_length(staging_mesh.normals) == 0)
+    {
+        free_quantized_mesh(&staging_mesh);
+        return false;
+    }
+
+    // Swap the placeholder for the loaded mesh.
+    free_quantized_mesh(&mesh);
+    mesh = staging_mesh;
+    memset(&staging_mesh, 0, sizeof(staging_mesh));
+
+    return true;
+}
+
+void free_loader(void)
+{
+    if (loader_thread)
+    {
+        SDL_AtomicSet(&loader_cancelled, 1);
+        SDL_WaitThread(loader_thread, NULL);
+        loader_thread = NULL;
+    }
+
+    free_queued_chunks();
+    free_quantized_mesh(&staging_mesh);
+    free(loader_filename);
+    loader_filename = NULL;
+}
@@ -0,0 +1,44 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stdbool.h>
+#include "mesh.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Number of OBJ lines the loader thread parses before publishing a chunk.
+ */
+#define LOADER_CHUNK_LINES 16384
+
+/**
+ * @brief Number of published chunks that can wait for the render side. Must be a power of two.
+ */
+#define LOADER_QUEUE_SIZE 64
+
+/**
+ * @brief Time in milliseconds the render side may spend uploading chunks in a single frame.
+ */
+#define LOADER_UPLOAD_BUDGET_MS 2
+#pragma endregion
+
+/**
+ * @brief Start loading an OBJ file on a background thread, which quantizes it chunk by chunk. The global mesh keeps
+ * being rendered as a placeholder until the whole file has been uploaded, then it is replaced.
+ * @param filename Path of the OBJ file. Copied, the caller may free it.
+ * @return True if the loader thread was started, false otherwise.
+ */
+bool load_obj_file_async(const char* filename);
+
+/**
+ * @brief Copy the quantized chunks published by the loader thread into the staging mesh, within the per frame budget,
+ * and replace the global mesh once the file is complete. Called once per frame by the render side.
+ * @return True if the global mesh was replaced during this call.
+ */
+bool upload_loaded_mesh_chunks(void);
+
+/**
+ * @brief Stop the loader thread, if any, and release everything it produced that was not uploaded.
+ */
+void free_loader(void);
+
+#endif
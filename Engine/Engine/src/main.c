@@ -6,6 +6,18 @@
 #include "display.h"
 #include "vector.h"
 #include "mesh.h"
+#include "texture.h"
+#include "matrix.h"
+#include "light.h"
+#include "sort.h"
+#include "scene.h"
+#include "loader.h"
+#include "bench.h"
+#include "raster.h"
+#include "tiles.h"
+#include "stress.h"
+#include "replay.h"
+#include "msaa.h"
 
 #pragma region Preprocessor directives
 /**
@@ -13,11 +25,56 @@
  */
 #define FOV_FACTOR (float)650
 
+/**
+ * @brief How far the camera moves per key press.
+ */
+#define CAMERA_STEP 0.1f
+
 /**
  * @brief The default color used when drawing things on the screen.
  */
 #define DEFAULT_RENDER_COLOR 0xFFFFFF00
 
+/**
+ * @brief The color of triangles filled without a texture.
+ */
+#define DEFAULT_FILL_COLOR 0xFFFFFFFF
+
+/**
+ * @brief The color of the triangle edges in wireframe mode.
+ */
+#define DEFAULT_WIREFRAME_COLOR 0xFF00FF00
+
+/**
+ * @brief Render option: draw the edges of every triangle.
+ */
+#define RENDER_OPTION_WIREFRAME 1
+
+/**
+ * @brief Render option: draw a marker on every vertex.
+ */
+#define RENDER_OPTION_VERTICES 2
+
+/**
+ * @brief Render option: fill the triangles.
+ */
+#define RENDER_OPTION_FILL 4
+
+/**
+ * @brief Render option: fill the triangles with the mesh texture instead of a flat color.
+ */
+#define RENDER_OPTION_TEXTURE 8
+
+/**
+ * @brief Render option: modulate the fill by the light level of each triangle.
+ */
+#define RENDER_OPTION_SHADING 16
+
+/**
+ * @brief Render option: antialias the edges of filled triangles with 4 coverage samples per pixel.
+ */
+#define RENDER_OPTION_MSAA 32
+
 /**
  * @brief The default grid color.
  */
@@ -28,6 +85,16 @@
  */
 #define CLEAR_BUFFER_COLOR 0xFF000000
 
+/**
+ * @brief Size in texels of the default mesh texture.
+ */
+#define DEFAULT_TEXTURE_SIZE 256
+
+/**
+ * @brief Number of checks along each side of the default mesh texture.
+ */
+#define DEFAULT_TEXTURE_CHECKS 8
+
 /**
  * @brief Error message for when the color buffer cannot be allocated.
  */
@@ -51,14 +118,55 @@ float uniform_axis_rotation = 0.01f;
 triangle_t* triangles_to_render = NULL;
 
 /**
- * @brief The position of the camera in 3D space.
+ * @brief Indices into triangles_to_render in the order they are drawn, farthest first.
+ */
+int* draw_order = NULL;
+
+/**
+ * @brief Cache holding the view space position of every mesh vertex. Only rebuilt when the mesh or its node moves.
+ */
+vec3_t* transformed_vertices = NULL;
+
+/**
+ * @brief The mesh vertices transformed_vertices was built from.
+ */
+const vec3_quantized_t* transformed_vertices_source = NULL;
+
+/**
+ * @brief The position of the camera in 3D space. Only used to place the camera node.
  */
 vec3_t camera_position = { 0, 0, -5 };
 
 /**
- * @brief Cube rotation vector in 3D space.
+ * @brief Scene node holding the view transform. Everything visible hangs below it.
+ */
+int camera_node = -1;
+
+/**
+ * @brief Scene node holding the transform of the mesh.
  */
-vec3_t cube_rotation = { 0, 0, 0 };
+int mesh_node = -1;
+
+/**
+ * @brief The active combination of RENDER_OPTION flags. Toggled with the 1 to 6 keys.
+ */
+int render_options = RENDER_OPTION_WIREFRAME | RENDER_OPTION_VERTICES | RENDER_OPTION_FILL | RENDER_OPTION_TEXTURE |
+	RENDER_OPTION_SHADING | RENDER_OPTION_MSAA;
+
+/**
+ * @brief Parameters of the stress scene loaded instead of the cube when enabled.
+ */
+stress_params_t stress_params;
+
+/**
+ * @brief Options of a scripted run.
+ */
+replay_options_t replay_options;
+
+/**
+ * @brief Set when the command line asked for a scripted run.
+ */
+bool scripted_run = false;
 
 /**
  * @brief Time elapsed since the previous frame.
@@ -72,8 +180,59 @@ bool is_running = false;
 #pragma endregion
 
 /**
- * @brief Initialize an SDL window and initialize the renderer.
- * @return True if the window was initialized successfully, false otherwise.
+ * @brief Build the scene graph and load the mesh and its texture. Needs no window.
+ */
+void setup_scene(void)
+{
+	// Build the scene graph. Moving the world away from the camera is the same as moving the camera.
+	const vec3_t camera_offset = { -camera_position.x, -camera_position.y, -camera_position.z };
+	camera_node = scene_add_node(SCENE_NO_PARENT);
+	scene_set_translation(camera_node, camera_offset);
+	mesh_node = scene_add_node(camera_node);
+
+	// Load the mesh and the texture wrapped around it. The cube also stands in while a mesh loads in the background.
+	if (stress_params.enabled)
+	{
+		load_stress_mesh_data(&stress_params);
+	}
+	else
+	{
+		load_cube_mesh_data();
+	}
+
+	const bool textured = texture_create_checkerboard(
+		&mesh_texture,
+		DEFAULT_TEXTURE_SIZE,
+		DEFAULT_TEXTURE_CHECKS,
+		0xFFFFFFFF,
+		0xFF3355AA
+	);
+
+	// Without the texture the textured kernels draw nothing, so fall back to flat colors. The texture reports why.
+	if (!textured)
+	{
+		render_options &= ~RENDER_OPTION_TEXTURE;
+	}
+}
+
+/**
+ * @brief Restore the background under everything the frame drew.
+ */
+void clear_frame(void)
+{
+	if (tiles_enabled)
+	{
+		clear_drawn_tiles(CLEAR_BUFFER_COLOR, DEFAULT_GRID_COLOR);
+	}
+	else
+	{
+		clear_color_buffer(CLEAR_BUFFER_COLOR);
+		draw_grid(DEFAULT_GRID_COLOR);
+	}
+}
+
+/**
+ * @brief Allocate the color buffer and the texture used to display it, then set up the scene.
  */
 void setup(void)
 {
@@ -99,6 +258,51 @@ void setup(void)
 	{
 		int _ = fprintf(stderr, CBUFFER_TEXTURE_CREATE_ERR);
 	}
+
+	// Every tile starts out drawn, so the first clear paints the whole background and the first upload sends it all.
+	// Without the tile grid every frame is cleared and uploaded whole instead.
+	tiles_enabled = tiles_resize(window_width, window_height);
+	clear_frame();
+
+	// Without the sample slots the multisampled kernels draw nothing, so fall back to aliased edges.
+	if (!msaa_resize(window_width, window_height))
+	{
+		render_options &= ~RENDER_OPTION_MSAA;
+	}
+
+	setup_scene();
+}
+
+/**
+ * @brief Move camera_position for a camera key.
+ * @param key The key that was pressed.
+ * @return False if the key does not move the camera.
+ */
+bool move_camera(const SDL_Keycode key)
+{
+	switch (key)
+	{
+		case SDLK_LEFT:
+			camera_position.x -= CAMERA_STEP;
+			return true;
+		case SDLK_RIGHT:
+			camera_position.x += CAMERA_STEP;
+			return true;
+		case SDLK_UP:
+			camera_position.y -= CAMERA_STEP;
+			return true;
+		case SDLK_DOWN:
+			camera_position.y += CAMERA_STEP;
+			return true;
+		case SDLK_PAGEUP:
+			camera_position.z += CAMERA_STEP;
+			return true;
+		case SDLK_PAGEDOWN:
+			camera_position.z -= CAMERA_STEP;
+			return true;
+		default:
+			return false;
+	}
 }
 
 /**
@@ -124,6 +328,37 @@ void process_input(void)
 			{
 				is_running = false;
 			}
+			// The number keys toggle the render options.
+			else if (event.key.keysym.sym == SDLK_1)
+			{
+				render_options ^= RENDER_OPTION_WIREFRAME;
+			}
+			else if (event.key.keysym.sym == SDLK_2)
+			{
+				render_options ^= RENDER_OPTION_VERTICES;
+			}
+			else if (event.key.keysym.sym == SDLK_3)
+			{
+				render_options ^= RENDER_OPTION_FILL;
+			}
+			else if (event.key.keysym.sym == SDLK_4 && mesh_texture.mip_levels > 0)
+			{
+				render_options ^= RENDER_OPTION_TEXTURE;
+			}
+			else if (event.key.keysym.sym == SDLK_5)
+			{
+				render_options ^= RENDER_OPTION_SHADING;
+			}
+			else if (event.key.keysym.sym == SDLK_6)
+			{
+				render_options ^= RENDER_OPTION_MSAA;
+			}
+			// The arrow keys and page up and down move the camera.
+			else if (move_camera(event.key.keysym.sym))
+			{
+				const vec3_t camera_offset = { -camera_position.x, -camera_position.y, -camera_position.z };
+				scene_set_translation(camera_node, camera_offset);
+			}
 			break;
 	}
 }
@@ -145,9 +380,9 @@ vec2_t project(const vec3_t point)
 }
 
 /**
- * @brief Update the game world.
+ * @brief Wait until the target frame time has passed since the previous frame.
  */
-void update(void)
+void wait_for_next_frame(void)
 {
 	// Wait some time until the target frame time in ms is reached.
 	const int time_to_wait = FRAME_TARGET_TIME - (SDL_GetTicks() - previous_frame_time);
@@ -158,40 +393,147 @@ void update(void)
 		SDL_Delay(time_to_wait);
 	}
 
-	// Initialize dynamic array of triangles to render.
-	triangles_to_render = NULL;
-	
 	// How many ms passed since the last frame? SDL has a function for this.
 	previous_frame_time = SDL_GetTicks();
+}
+
+/**
+ * @brief Put the mesh back in its initial orientation and the script back on its first frame.
+ */
+void reset_scene(void)
+{
+	const vec3_t initial_rotation = { 0, 0, 0 };
+	scene_set_rotation(mesh_node, initial_rotation);
+	replay_rewind();
+}
+
+/**
+ * @brief Load or generate the script of a scripted run, and start recording if asked to.
+ * @return False if a script could not be read or written.
+ */
+bool setup_replay(void)
+{
+	if (replay_options.replay_file)
+	{
+		if (!replay_load(replay_options.replay_file))
+		{
+			return false;
+		}
+	}
+	// Scripted runs without a script, and stress scenes unless the user is recording their own path, follow the
+	// built-in camera path.
+	else if ((scripted_run || stress_params.enabled) && !replay_options.record_file)
+	{
+		replay_generate(replay_options.frames);
+	}
+
+	return !replay_options.record_file || replay_record_start(replay_options.record_file);
+}
+
+/**
+ * @brief Update the game world.
+ */
+void update(void)
+{
+	// Initialize dynamic array of triangles to render.
+	triangles_to_render = NULL;
 	
-	// Set the rotation amount for the cube points in each direction.
-	cube_rotation.x += uniform_axis_rotation;
-	cube_rotation.y += uniform_axis_rotation;
-	cube_rotation.z += uniform_axis_rotation;
+	// Pick up whatever the background loader finished since the last frame.
+	upload_loaded_mesh_chunks();
+
+	// A script sets both nodes every frame, so a replay shows exactly what was recorded.
+	replay_frame_t script_frame;
 
-	// Loop through all the triangle faces that compose our cube mesh.
-	for (int i = 0; i < N_MESH_FACES; i++)
+	if (replay_is_playing())
+	{
+		if (replay_next(&script_frame))
+		{
+			scene_set_translation(camera_node, script_frame.camera_translation);
+			scene_set_rotation(camera_node, script_frame.camera_rotation);
+			scene_set_translation(mesh_node, script_frame.mesh_translation);
+			scene_set_rotation(mesh_node, script_frame.mesh_rotation);
+		}
+		else
+		{
+			// Every frame of the script has been shown.
+			is_running = false;
+		}
+	}
+	else
+	{
+		// Set the rotation amount for the mesh in each direction.
+		vec3_t mesh_rotation = scene_nodes[mesh_node].rotation;
+		mesh_rotation.x += uniform_axis_rotation;
+		mesh_rotation.y += uniform_axis_rotation;
+		mesh_rotation.z += uniform_axis_rotation;
+		scene_set_rotation(mesh_node, mesh_rotation);
+	}
+
+	script_frame.camera_translation = scene_nodes[camera_node].translation;
+	script_frame.camera_rotation = scene_nodes[camera_node].rotation;
+	script_frame.mesh_translation = scene_nodes[mesh_node].translation;
+	script_frame.mesh_rotation = scene_nodes[mesh_node].rotation;
+	replay_record(&script_frame);
+
+	// Only the nodes that moved since the last frame recompute their matrices.
+	scene_update();
+	const mat4_t* world_matrix = &scene_nodes[mesh_node].world;
+
+	// Transform every vertex once, faces share them. Nothing to do if neither the mesh nor its node changed.
+	const int num_vertices = array_length(mesh.positions);
+
+	if (scene_node_changed(mesh_node) || transformed_vertices_source != mesh.positions)
+	{
+		if (array_length(transformed_vertices) != num_vertices)
+		{
+			array_free(transformed_vertices);
+			transformed_vertices = (num_vertices > 0) ? array_hold(NULL, num_vertices, sizeof(vec3_t)) : NULL;
+		}
+
+		// Dequantizing is a scale and a translation, folded into the world matrix so it costs nothing per vertex.
+		const mat4_t vertex_matrix = mat4_mul_mat4(world_matrix, &mesh.dequantize);
+
+		for (int i = 0; i < num_vertices; i++)
+		{
+			const vec3_quantized_t position = mesh.positions[i];
+			const vec3_t vertex = { (float)position.x, (float)position.y, (float)position.z };
+			transformed_vertices[i] = mat4_mul_point(&vertex_matrix, vertex);
+		}
+
+		transformed_vertices_source = mesh.positions;
+	}
+
+	// Loop through all the triangle faces that compose our mesh.
+	const int num_faces = array_length(mesh.normals);
+
+	for (int i = 0; i < num_faces; i++)
 	{
-		face_t mesh_face = mesh_faces[i];
-		
 		vec3_t face_vertices[3];
-		face_vertices[0] = mesh_vertices[mesh_face.a - 1];
-		face_vertices[1] = mesh_vertices[mesh_face.b - 1];
-		face_vertices[2] = mesh_vertices[mesh_face.c - 1];
+		face_vertices[0] = transformed_vertices[mesh_vertex_index(&mesh, i, 0)];
+		face_vertices[1] = transformed_vertices[mesh_vertex_index(&mesh, i, 1)];
+		face_vertices[2] = transformed_vertices[mesh_vertex_index(&mesh, i, 2)];
+
+		// The precomputed normal only needs the rotation, which leaves it at unit length.
+		const vec3_t normal = mat4_mul_direction(world_matrix, normal_unpack(mesh.normals[i]));
+
+		// Skip faces pointing away from the camera, which sits at the view space origin.
+		const vec3_t camera_ray = { -face_vertices[0].x, -face_vertices[0].y, -face_vertices[0].z };
+
+		if (vec3_dot(normal, camera_ray) < 0)
+		{
+			continue;
+		}
 
 		triangle_t projected_triangle;
+		projected_triangle.light_level = (int16_t)light_level_from_normal(normal);
+		projected_triangle.texcoord_bits = mesh.texcoord_bits[i];
+		projected_triangle.color = DEFAULT_FILL_COLOR;
+		projected_triangle.depth = (face_vertices[0].z + face_vertices[1].z + face_vertices[2].z) / 3.0f;
 		
-		// Loop all three vertices of the current face and apply transformations.
+		// Loop all three vertices of the current face and project them.
 		for (int j = 0; j < 3; j++)
 		{
-			vec3_t transformed_vertex = face_vertices[j];
-
-			transformed_vertex = vec3_rotate_x(transformed_vertex, cube_rotation.x);
-			transformed_vertex = vec3_rotate_y(transformed_vertex, cube_rotation.y);
-			transformed_vertex = vec3_rotate_z(transformed_vertex, cube_rotation.z);
-
-			// Translate vertex away from camera.
-			transformed_vertex.z -= camera_position.z;
+			const vec3_t transformed_vertex = face_vertices[j];
 
 			// Project the current vertex.
 			vec2_t projected_point = project(transformed_vertex);
@@ -200,101 +542,211 @@ void update(void)
 			projected_point.x += (window_width / 2);
 			projected_point.y += (window_height / 2);
 			
-			projected_triangle.points[j] = projected_point;
+			// Snap to the subpixel grid, everything after this point works in integers.
+			projected_triangle.points[j] = vec2_to_fixed(projected_point);
+			projected_triangle.inv_depths[j] = 1.0f / transformed_vertex.z;
+
+			// The texture coordinates were packed when the mesh was quantized.
+			projected_triangle.texcoords[j] = mesh.texcoords[(i * N_POINTS_TRIANGLE) + j];
 		}
 
 		// Save the projected triangle to the dynamic array of triangles to render.
 		array_push(triangles_to_render, projected_triangle);
 	}
+
+	// Without a depth buffer, painting the farthest triangles first keeps the nearest ones on top.
+	const int num_triangles = array_length(triangles_to_render);
+
+	if (array_length(draw_order) != num_triangles)
+	{
+		array_free(draw_order);
+		draw_order = (num_triangles > 0) ? array_hold(NULL, num_triangles, sizeof(int)) : NULL;
+	}
+
+	sort_triangles_back_to_front(triangles_to_render, num_triangles, draw_order);
 }
 
 /**
- * @brief Render the color buffer to the screen.
+ * @brief Draw the grid and the triangles emitted by update() into the color buffer.
  */
-void render(void)
+void draw_frame(void)
 {
-	draw_grid(DEFAULT_GRID_COLOR);
-	
+	// Resolve the options into kernels once per frame, so no option is tested per pixel.
+	const bool draw_wireframe = (render_options & RENDER_OPTION_WIREFRAME) != 0;
+	const bool draw_vertices = (render_options & RENDER_OPTION_VERTICES) != 0;
+	const fill_triangle_kernel_t fill_triangle = (render_options & RENDER_OPTION_FILL)
+		? raster_kernels.fill_triangle[
+			((render_options & RENDER_OPTION_TEXTURE) ? RASTER_FILL_TEXTURED : 0) |
+			((render_options & RENDER_OPTION_SHADING) ? RASTER_FILL_SHADED : 0) |
+			((render_options & RENDER_OPTION_MSAA) ? RASTER_FILL_MSAA : 0)]
+		: NULL;
+
 	// Loop all projected triangles and render them.
 	const int num_triangles = array_length(triangles_to_render);
 	
 	for (int i = 0; i < num_triangles; i++)
 	{
-		const triangle_t triangle = triangles_to_render[i];
+		const triangle_t triangle = triangles_to_render[draw_order[i]];
 		const int desired_width = 10;
 		const int desired_height = 10;
 
+		if (!fill_triangle && !draw_vertices && !draw_wireframe)
+		{
+			continue;
+		}
+
+		// Only the tiles under something drawn get cleared and uploaded. The bounds reach past the triangle by the
+		// rounding of the line end points and by the size of the vertex markers.
+		const int min_x = fixed_to_pixel(SDL_min(triangle.points[0].x, SDL_min(triangle.points[1].x, triangle.points[2].x)));
+		const int min_y = fixed_to_pixel(SDL_min(triangle.points[0].y, SDL_min(triangle.points[1].y, triangle.points[2].y)));
+		const int max_x = fixed_to_pixel(SDL_max(triangle.points[0].x, SDL_max(triangle.points[1].x, triangle.points[2].x)));
+		const int max_y = fixed_to_pixel(SDL_max(triangle.points[0].y, SDL_max(triangle.points[1].y, triangle.points[2].y)));
+		tiles_mark_rect(min_x - 1, min_y - 1, max_x + desired_width, max_y + desired_height);
+
+		if (fill_triangle)
+		{
+			fill_triangle(&triangle, &mesh_texture);
+		}
+
 		// Draw vertex points.
-		draw_rect(
-			DEFAULT_RENDER_COLOR,
-			triangle.points[0].x,
-			triangle.points[0].y,
-			desired_width,
-			desired_height
-			);
-		draw_rect(
-			DEFAULT_RENDER_COLOR,
-			triangle.points[1].x,
-			triangle.points[1].y,
-			desired_width,
-			desired_height
-			);
-		draw_rect(
-			DEFAULT_RENDER_COLOR,
-			triangle.points[2].x,
-			triangle.points[2].y,
-			desired_width,
-			desired_height
-			);
+		if (draw_vertices)
+		{
+			for (int j = 0; j < N_POINTS_TRIANGLE; j++)
+			{
+				draw_rect(
+					DEFAULT_RENDER_COLOR,
+					(float)fixed_to_pixel(triangle.points[j].x),
+					(float)fixed_to_pixel(triangle.points[j].y),
+					desired_width,
+					desired_height
+					);
+			}
+		}
 
 		// Draw the lines of the triangle.
-		draw_line_DDA(
-			0xFF00FF00,
-			triangle.points[0],
-			triangle.points[1]
-			);
-		draw_line_DDA(
-			0xFF00FF00,
-			triangle.points[1],
-			triangle.points[2]
-			);
-		draw_line_DDA(
-			0xFF00FF00,
-			triangle.points[2],
-			triangle.points[0]
-			);
+		if (draw_wireframe)
+		{
+			for (int j = 0; j < N_POINTS_TRIANGLE; j++)
+			{
+				draw_line_fixed(
+					DEFAULT_WIREFRAME_COLOR,
+					triangle.points[j],
+					triangle.points[(j + 1) % N_POINTS_TRIANGLE]
+					);
+			}
+		}
 	}
 
+	// Average the samples of the edge pixels into the color buffer before it is uploaded.
+	msaa_resolve();
+
 	// Clear the array of triangles to render every frame loop.
 	array_free(triangles_to_render);
-	
+	triangles_to_render = NULL;
+}
+
+/**
+ * @brief Render the color buffer to the screen.
+ */
+void render(void)
+{
+	draw_frame();
 	render_color_buffer();
-	clear_color_buffer(CLEAR_BUFFER_COLOR);
+	clear_frame();
 	
 	// Update the screen with the color we chose.
 	SDL_RenderPresent(renderer);
 }
 
+/**
+ * @brief Release the resources owned by the scene.
+ */
+void free_resources(void)
+{
+	free_loader();
+	free_mesh_data();
+	texture_free(&mesh_texture);
+	array_free(transformed_vertices);
+	array_free(draw_order);
+	free_sort_buffers();
+	free_scene();
+	free_tiles();
+	free_msaa();
+	free_replay();
+}
+
 /**
  * @brief Main entry point of the application.
  * @param argc The number of command line arguments.
- * @param argv The command line arguments.
+ * @param argv The command line arguments. An optional OBJ file to load in the background, then stress scene and
+ * script options. With --benchmark the run is headless.
  * @return 0 if the application ran successfully, 1 otherwise.
  */
 int main(int argc, char* argv[])
 {
+	// Pick the kernels for this CPU before anything is drawn.
+	select_raster_kernels();
+
+	parse_stress_params(argc, argv, &stress_params);
+	scripted_run = parse_replay_options(argc, argv, &replay_options);
+
+	// Headless benchmark run, no window is created.
+	bench_options_t bench_options;
+
+	if (parse_bench_options(argc, argv, &bench_options))
+	{
+		const bench_frame_t bench_frame = { reset_scene, clear_frame, update, draw_frame };
+		int result = 1;
+
+		setup_scene();
+
+		if (setup_replay())
+		{
+			result = replay_is_playing()
+				? run_scripted_benchmark(&replay_options, &bench_frame)
+				: run_benchmarks(&bench_options, &bench_frame);
+		}
+
+		free_resources();
+
+		return result;
+	}
+
 	is_running = initialize_window();
 
 	setup();
 
+	if (!setup_replay())
+	{
+		is_running = false;
+	}
+
+	// Stream the mesh in while the placeholder is on screen, so the first frame does not wait for the file.
+	if (argc > 1 && argv[1][0] != '-')
+	{
+		load_obj_file_async(argv[1]);
+	}
+
 	// Render loop. Also called a game loop.
 	while (is_running)
 	{
 		process_input();
+		wait_for_next_frame();
+
+		const uint64_t frame_start = SDL_GetPerformanceCounter();
 		update();
 		render();
+
+		// Scripted runs keep the time spent on every frame, waiting excluded.
+		if (replay_is_playing() && is_running)
+		{
+			replay_time_frame(1000.0 * (double)(SDL_GetPerformanceCounter() - frame_start) /
+				(double)SDL_GetPerformanceFrequency());
+		}
 	}
 
+	replay_report(&replay_options);
+	free_resources();
 	destroy_window();
 	
 	return 0;
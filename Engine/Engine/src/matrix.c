@@ -0,0 +1,117 @@
+#include <math.h>
+#include "matrix.h"
+
+mat4_t mat4_identity(void)
+{
+    const mat4_t identity = { .m = {
+        { 1, 0, 0, 0 },
+        { 0, 1, 0, 0 },
+        { 0, 0, 1, 0 },
+        { 0, 0, 0, 1 }
+    } };
+
+    return identity;
+}
+
+mat4_t mat4_make_translation(const vec3_t translation)
+{
+    mat4_t matrix = mat4_identity();
+    matrix.m[0][3] = translation.x;
+    matrix.m[1][3] = translation.y;
+    matrix.m[2][3] = translation.z;
+
+    return matrix;
+}
+
+mat4_t mat4_make_scale(const vec3_t scale)
+{
+    mat4_t matrix = mat4_identity();
+    matrix.m[0][0] = scale.x;
+    matrix.m[1][1] = scale.y;
+    matrix.m[2][2] = scale.z;
+
+    return matrix;
+}
+
+mat4_t mat4_make_rotation_x(const float angle)
+{
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+
+    mat4_t matrix = mat4_identity();
+    matrix.m[1][1] = c;
+    matrix.m[1][2] = -s;
+    matrix.m[2][1] = s;
+    matrix.m[2][2] = c;
+
+    return matrix;
+}
+
+mat4_t mat4_make_rotation_y(const float angle)
+{
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+
+    mat4_t matrix = mat4_identity();
+    matrix.m[0][0] = c;
+    matrix.m[0][2] = -s;
+    matrix.m[2][0] = s;
+    matrix.m[2][2] = c;
+
+    return matrix;
+}
+
+mat4_t mat4_make_rotation_z(const float angle)
+{
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+
+    mat4_t matrix = mat4_identity();
+    matrix.m[0][0] = c;
+    matrix.m[0][1] = -s;
+    matrix.m[1][0] = s;
+    matrix.m[1][1] = c;
+
+    return matrix;
+}
+
+mat4_t mat4_mul_mat4(const mat4_t* a, const mat4_t* b)
+{
+    mat4_t result;
+
+    for (int row = 0; row < 4; row++)
+    {
+        for (int column = 0; column < 4; column++)
+        {
+            result.m[row][column] =
+                a->m[row][0] * b->m[0][column] +
+                a->m[row][1] * b->m[1][column] +
+                a->m[row][2] * b->m[2][column] +
+                a->m[row][3] * b->m[3][column];
+        }
+    }
+
+    return result;
+}
+
+vec3_t mat4_mul_point(const mat4_t* matrix, const vec3_t point)
+{
+    const vec3_t result = {
+        .x = matrix->m[0][0] * point.x + matrix->m[0][1] * point.y + matrix->m[0][2] * point.z + matrix->m[0][3],
+        .y = matrix->m[1][0] * point.x + matrix->m[1][1] * point.y + matrix->m[1][2] * point.z + matrix->m[1][3],
+        .z = matrix->m[2][0] * point.x + matrix->m[2][1] * point.y + matrix->m[2][2] * point.z + matrix->m[2][3]
+    };
+
+    return result;
+}
+
+vec3_t mat4_mul_direction(const mat4_t* matrix, const vec3_t direction)
+{
+    const vec3_t result = {
+        .x = matrix->m[0][0] * direction.x + matrix->m[0][1] * direction.y + matrix->m[0][2] * direction.z,
+        .y = matrix->m[1][0] * direction.x + matrix->m[1][1] * direction.y + matrix->m[1][2] * direction.z,
+        .z = matrix->m[2][0] * direction.x + matrix->m[2][1] * direction.y + matrix->m[2][2] * direction.z
+    };
+
+    return result;
+}
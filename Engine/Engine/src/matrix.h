@@ -0,0 +1,87 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "vector.h"
+
+/**
+ * @file matrix.h
+ * @brief This file contains the definition of the matrix type.
+ */
+
+/**
+ * @brief A 4x4 row-major matrix used for affine transforms. Vectors are treated as columns.
+ */
+typedef struct
+{
+    /**
+     * @brief The matrix elements, indexed as m[row][column].
+     */
+    float m[4][4];
+} mat4_t;
+
+/**
+ * @brief Create an identity matrix.
+ * @return The identity matrix.
+ */
+mat4_t mat4_identity(void);
+
+/**
+ * @brief Create a translation matrix.
+ * @param translation The offset to translate by.
+ * @return The translation matrix.
+ */
+mat4_t mat4_make_translation(const vec3_t translation);
+
+/**
+ * @brief Create a matrix that scales each axis separately.
+ * @param scale The factor of each axis.
+ * @return The scale matrix.
+ */
+mat4_t mat4_make_scale(const vec3_t scale);
+
+/**
+ * @brief Create a matrix that rotates around the x-axis. Matches vec3_rotate_x.
+ * @param angle The angle to rotate by in radians.
+ * @return The rotation matrix.
+ */
+mat4_t mat4_make_rotation_x(const float angle);
+
+/**
+ * @brief Create a matrix that rotates around the y-axis. Matches vec3_rotate_y.
+ * @param angle The angle to rotate by in radians.
+ * @return The rotation matrix.
+ */
+mat4_t mat4_make_rotation_y(const float angle);
+
+/**
+ * @brief Create a matrix that rotates around the z-axis. Matches vec3_rotate_z.
+ * @param angle The angle to rotate by in radians.
+ * @return The rotation matrix.
+ */
+mat4_t mat4_make_rotation_z(const float angle);
+
+/**
+ * @brief Multiply two matrices. The result applies b first, then a.
+ * @param a The left hand side matrix.
+ * @param b The right hand side matrix.
+ * @return The product a * b.
+ */
+mat4_t mat4_mul_mat4(const mat4_t* a, const mat4_t* b);
+
+/**
+ * @brief Transform a point, applying both the linear part and the translation of the matrix.
+ * @param matrix The transform.
+ * @param point The point to transform.
+ * @return The transformed point.
+ */
+vec3_t mat4_mul_point(const mat4_t* matrix, const vec3_t point);
+
+/**
+ * @brief Transform a direction, applying only the linear part of the matrix.
+ * @param matrix The transform.
+ * @param direction The direction to transform.
+ * @return The transformed direction.
+ */
+vec3_t mat4_mul_direction(const mat4_t* matrix, const vec3_t direction);
+
+#endif
@@ -1,6 +1,19 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/array.h"
 #include "mesh.h"
 
-vec3_t mesh_vertices[N_MESH_VERTICES] = {
+mesh_quantized_t mesh = {
+    .positions = NULL,
+    .short_indices = NULL,
+    .long_indices = NULL,
+    .texcoords = NULL,
+    .texcoord_bits = NULL,
+    .normals = NULL
+};
+
+vec3_t cube_vertices[N_CUBE_VERTICES] = {
     { .x = -1, .y = -1, .z = -1 },
     { .x = -1, .y =  1, .z = -1 },
     { .x =  1, .y =  1, .z = -1 },
@@ -11,24 +24,401 @@ vec3_t mesh_vertices[N_MESH_VERTICES] = {
     { .x = -1, .y = -1, .z =  1 }
 };
 
-face_t mesh_faces[N_MESH_FACES] = {
+face_t cube_faces[N_CUBE_FACES] = {
     // 6 cube faces * 2 triangles per face.
     // Front
-    { .a = 1, .b = 2, .c = 3 },
-    { .a = 1, .b = 3, .c = 4 },
+    { .a = 1, .b = 2, .c = 3, .a_uv = { 0, 1 }, .b_uv = { 0, 0 }, .c_uv = { 1, 0 } },
+    { .a = 1, .b = 3, .c = 4, .a_uv = { 0, 1 }, .b_uv = { 1, 0 }, .c_uv = { 1, 1 } },
     // Right
-    { .a = 4, .b = 3, .c = 5 },
-    { .a = 4, .b = 5, .c = 6 },
+    { .a = 4, .b = 3, .c = 5, .a_uv = { 0, 1 }, .b_uv = { 0, 0 }, .c_uv = { 1, 0 } },
+    { .a = 4, .b = 5, .c = 6, .a_uv = { 0, 1 }, .b_uv = { 1, 0 }, .c_uv = { 1, 1 } },
     // Back
-    { .a = 6, .b = 5, .c = 7 },
-    { .a = 6, .b = 7, .c = 8 },
+    { .a = 6, .b = 5, .c = 7, .a_uv = { 0, 1 }, .b_uv = { 0, 0 }, .c_uv = { 1, 0 } },
+    { .a = 6, .b = 7, .c = 8, .a_uv = { 0, 1 }, .b_uv = { 1, 0 }, .c_uv = { 1, 1 } },
     // Left
-    { .a = 8, .b = 7, .c = 2 },
-    { .a = 8, .b = 2, .c = 1 },
+    { .a = 8, .b = 7, .c = 2, .a_uv = { 0, 1 }, .b_uv = { 0, 0 }, .c_uv = { 1, 0 } },
+    { .a = 8, .b = 2, .c = 1, .a_uv = { 0, 1 }, .b_uv = { 1, 0 }, .c_uv = { 1, 1 } },
     // Top
-    { .a = 2, .b = 7, .c = 5 },
-    { .a = 2, .b = 5, .c = 3 },
+    { .a = 2, .b = 7, .c = 5, .a_uv = { 0, 1 }, .b_uv = { 0, 0 }, .c_uv = { 1, 0 } },
+    { .a = 2, .b = 5, .c = 3, .a_uv = { 0, 1 }, .b_uv = { 1, 0 }, .c_uv = { 1, 1 } },
     // Bottom
-    { .a = 6, .b = 8, .c = 1 },
-    { .a = 6, .b = 1, .c = 4 }
-};
\ No newline at end of file
+    { .a = 6, .b = 8, .c = 1, .a_uv = { 0, 1 }, .b_uv = { 0, 0 }, .c_uv = { 1, 0 } },
+    { .a = 6, .b = 1, .c = 4, .a_uv = { 0, 1 }, .b_uv = { 1, 0 }, .c_uv = { 1, 1 } }
+};
+
+void load_cube_mesh_data(void)
+{
+    mesh_t cube = { 0 };
+
+    for (int i = 0; i < N_CUBE_VERTICES; i++)
+    {
+        array_push(cube.vertices, cube_vertices[i]);
+    }
+
+    for (int i = 0; i < N_CUBE_FACES; i++)
+    {
+        array_push(cube.faces, cube_faces[i]);
+    }
+
+    compute_mesh_normals(&cube);
+    quantize_mesh(&mesh, &cube);
+    free_mesh(&cube);
+}
+
+/**
+ * @brief Parse one "v", "v/vt", "v//vn" or "v/vt/vn" face corner.
+ * @param token The text of the corner. Advanced past the corner on return.
+ * @param vertex_index Receives the 1-based vertex index.
+ * @param texcoord_index Receives the 1-based texture coordinate index, or 0 if there is none.
+ * @return True if a corner was parsed, false at the end of the line.
+ */
+static bool parse_face_corner(char** token, long* vertex_index, long* texcoord_index)
+{
+    char* end = NULL;
+
+    *vertex_index = strtol(*token, &end, 10);
+    *texcoord_index = 0;
+
+    if (end == *token)
+    {
+        return false;
+    }
+
+    if (*end == '/')
+    {
+        char* texcoord_start = end + 1;
+        *texcoord_index = strtol(texcoord_start, &end, 10);
+
+        // Skip the normal index, we compute our own normals.
+        if (*end == '/')
+        {
+            (void)strtol(end + 1, &end, 10);
+        }
+    }
+
+    *token = end;
+    return true;
+}
+
+/**
+ * @brief Turn a 1-based, possibly negative (relative) OBJ index into a 1-based absolute index.
+ */
+static long resolve_obj_index(const long index, const int count)
+{
+    return (index < 0) ? count + index + 1 : index;
+}
+
+void obj_parse_line(obj_parser_t* parser, const char* line)
+{
+    if (strncmp(line, "v ", 2) == 0)
+    {
+        char* cursor = (char*)line + 2;
+        vec3_t vertex;
+        vertex.x = strtof(cursor, &cursor);
+        vertex.y = strtof(cursor, &cursor);
+        vertex.z = strtof(cursor, &cursor);
+        array_push(parser->vertices, vertex);
+        parser->vertex_count++;
+    }
+    else if (strncmp(line, "vt ", 3) == 0)
+    {
+        char* cursor = (char*)line + 3;
+        tex2_t texcoord;
+        texcoord.u = strtof(cursor, &cursor);
+        // OBJ texture coordinates grow upwards, our textures grow downwards.
+        texcoord.v = 1.0f - strtof(cursor, &cursor);
+        array_push(parser->texcoords, texcoord);
+    }
+    else if (strncmp(line, "f ", 2) == 0)
+    {
+        char* cursor = (char*)line + 2;
+        const int n_vertices = parser->vertex_count;
+        const int n_texcoords = array_length(parser->texcoords);
+        long first_v, first_vt, previous_v, previous_vt, current_v, current_vt;
+
+        if (!parse_face_corner(&cursor, &first_v, &first_vt) ||
+            !parse_face_corner(&cursor, &previous_v, &previous_vt))
+        {
+            return;
+        }
+
+        // Split the polygon into a triangle fan around its first corner.
+        while (parse_face_corner(&cursor, &current_v, &current_vt))
+        {
+            const long corner_v[N_POINTS_TRIANGLE] = { first_v, previous_v, current_v };
+            const long corner_vt[N_POINTS_TRIANGLE] = { first_vt, previous_vt, current_vt };
+            tex2_t corner_uv[N_POINTS_TRIANGLE] = { { 0, 0 }, { 0, 0 }, { 0, 0 } };
+
+            for (int i = 0; i < N_POINTS_TRIANGLE; i++)
+            {
+                const long vt = resolve_obj_index(corner_vt[i], n_texcoords);
+
+                if (vt >= 1 && vt <= n_texcoords)
+                {
+                    corner_uv[i] = parser->texcoords[vt - 1];
+                }
+            }
+
+            long indices[N_POINTS_TRIANGLE];
+            bool valid = true;
+
+            for (int i = 0; i < N_POINTS_TRIANGLE; i++)
+            {
+                indices[i] = resolve_obj_index(corner_v[i], n_vertices);
+                valid = valid && indices[i] >= 1 && indices[i] <= n_vertices;
+            }
+
+            previous_v = current_v;
+            previous_vt = current_vt;
+
+            // Drop faces that reference vertices we have not seen.
+            if (!valid)
+            {
+                continue;
+            }
+
+            const face_t face = {
+                .a = (unsigned int)indices[0],
+                .b = (unsigned int)indices[1],
+                .c = (unsigned int)indices[2],
+                .a_uv = corner_uv[0],
+                .b_uv = corner_uv[1],
+                .c_uv = corner_uv[2]
+            };
+            array_push(parser->faces, face);
+        }
+    }
+}
+
+void free_obj_parser(obj_parser_t* parser)
+{
+    array_free(parser->vertices);
+    array_free(parser->faces);
+    array_free(parser->texcoords);
+    parser->vertices = NULL;
+    parser->faces = NULL;
+    parser->texcoords = NULL;
+    parser->vertex_count = 0;
+}
+
+void compute_mesh_normals(mesh_t* target)
+{
+    const int num_faces = array_length(target->faces);
+    const int first_face = array_length(target->normals);
+
+    if (num_faces <= first_face)
+    {
+        return;
+    }
+
+    target->normals = array_hold(target->normals, num_faces - first_face, sizeof(vec3_t));
+
+    for (int i = first_face; i < num_faces; i++)
+    {
+        const face_t face = target->faces[i];
+        const vec3_t a = target->vertices[face.a - 1];
+        const vec3_t b = target->vertices[face.b - 1];
+        const vec3_t c = target->vertices[face.c - 1];
+
+        // Faces are wound clockwise, so (b - a) x (c - a) points out of the mesh.
+        target->normals[i] = vec3_normalize(vec3_cross(vec3_sub(b, a), vec3_sub(c, a)));
+    }
+}
+
+void free_mesh(mesh_t* target)
+{
+    array_free(target->vertices);
+    array_free(target->faces);
+    array_free(target->normals);
+    target->vertices = NULL;
+    target->faces = NULL;
+    target->normals = NULL;
+}
+
+/**
+ * @brief Quantize one component of a position to its step within the bounds.
+ */
+static uint16_t quantize_component(const float value, const float lower, const float step)
+{
+    if (step <= 0.0f)
+    {
+        return 0;
+    }
+
+    const long quantized = lrintf((value - lower) / step);
+
+    return (uint16_t)((quantized < 0) ? 0 : ((quantized > MESH_POSITION_MAX) ? MESH_POSITION_MAX : quantized));
+}
+
+/**
+ * @brief Pack one octahedral normal component.
+ */
+static int16_t pack_normal_component(const float value)
+{
+    const long packed = lrintf(value * MESH_NORMAL_ONE);
+
+    return (int16_t)((packed < -MESH_NORMAL_ONE) ? -MESH_NORMAL_ONE :
+        ((packed > MESH_NORMAL_ONE) ? MESH_NORMAL_ONE : packed));
+}
+
+/**
+ * @brief Pack a unit normal in octahedral form.
+ */
+static normal_packed_t normal_pack(const vec3_t normal)
+{
+    const float sum = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    float x = (sum > 0.0f) ? normal.x / sum : 0.0f;
+    float y = (sum > 0.0f) ? normal.y / sum : 0.0f;
+
+    // Fold the lower half of the octahedron over the upper one.
+    if (normal.z < 0.0f)
+    {
+        const float folded_x = (1.0f - fabsf(y)) * ((x >= 0.0f) ? 1.0f : -1.0f);
+        const float folded_y = (1.0f - fabsf(x)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    const normal_packed_t packed = { .x = pack_normal_component(x), .y = pack_normal_component(y) };
+
+    return packed;
+}
+
+void quantize_mesh(mesh_quantized_t* target, const mesh_t* source)
+{
+    mesh_bounds_t bounds = { 0 };
+    extend_mesh_bounds(&bounds, source->vertices);
+
+    const mesh_quantizer_t quantizer = make_mesh_quantizer(&bounds);
+    mesh_quantized_t quantized = { 0 };
+    quantize_mesh_part(&quantized, &quantizer, source->vertices, source->faces, source->normals);
+
+    free_quantized_mesh(target);
+    *target = quantized;
+}
+
+void extend_mesh_bounds(mesh_bounds_t* bounds, const vec3_t* vertices)
+{
+    const int num_vertices = array_length((void*)vertices);
+
+    for (int i = 0; i < num_vertices; i++)
+    {
+        const vec3_t vertex = vertices[i];
+        const bool first = bounds->num_vertices == 0;
+        bounds->lower.x = (first || vertex.x < bounds->lower.x) ? vertex.x : bounds->lower.x;
+        bounds->lower.y = (first || vertex.y < bounds->lower.y) ? vertex.y : bounds->lower.y;
+        bounds->lower.z = (first || vertex.z < bounds->lower.z) ? vertex.z : bounds->lower.z;
+        bounds->upper.x = (first || vertex.x > bounds->upper.x) ? vertex.x : bounds->upper.x;
+        bounds->upper.y = (first || vertex.y > bounds->upper.y) ? vertex.y : bounds->upper.y;
+        bounds->upper.z = (first || vertex.z > bounds->upper.z) ? vertex.z : bounds->upper.z;
+        bounds->num_vertices++;
+    }
+}
+
+mesh_quantizer_t make_mesh_quantizer(const mesh_bounds_t* bounds)
+{
+    mesh_quantizer_t quantizer = { 0 };
+
+    // Bounds of the vertices, split into 65535 steps per axis.
+    if (bounds->num_vertices > 0)
+    {
+        quantizer.lower = bounds->lower;
+        quantizer.step.x = (bounds->upper.x - bounds->lower.x) / MESH_POSITION_MAX;
+        quantizer.step.y = (bounds->upper.y - bounds->lower.y) / MESH_POSITION_MAX;
+        quantizer.step.z = (bounds->upper.z - bounds->lower.z) / MESH_POSITION_MAX;
+    }
+
+    const mat4_t scale = mat4_make_scale(quantizer.step);
+    const mat4_t translation = mat4_make_translation(quantizer.lower);
+    quantizer.dequantize = mat4_mul_mat4(&translation, &scale);
+    quantizer.short_indices = bounds->num_vertices <= MESH_SHORT_INDEX_VERTICES;
+
+    return quantizer;
+}
+
+void quantize_mesh_part(mesh_quantized_t* target, const mesh_quantizer_t* quantizer, const vec3_t* vertices,
+    const face_t* faces, const vec3_t* normals)
+{
+    const int num_vertices = array_length((void*)vertices);
+    const int num_faces = array_length((void*)faces);
+    const int first_vertex = array_length(target->positions);
+    const int first_face = array_length(target->normals);
+    target->dequantize = quantizer->dequantize;
+
+    if (num_vertices > 0)
+    {
+        target->positions = array_hold(target->positions, num_vertices, sizeof(vec3_quantized_t));
+    }
+
+    for (int i = 0; i < num_vertices; i++)
+    {
+        const vec3_t vertex = vertices[i];
+        vec3_quantized_t* position = &target->positions[first_vertex + i];
+        position->x = quantize_component(vertex.x, quantizer->lower.x, quantizer->step.x);
+        position->y = quantize_component(vertex.y, quantizer->lower.y, quantizer->step.y);
+        position->z = quantize_component(vertex.z, quantizer->lower.z, quantizer->step.z);
+    }
+
+    if (num_faces > 0)
+    {
+        const int num_indices = num_faces * N_POINTS_TRIANGLE;
+
+        if (quantizer->short_indices)
+        {
+            target->short_indices = array_hold(target->short_indices, num_indices, sizeof(uint16_t));
+        }
+        else
+        {
+            target->long_indices = array_hold(target->long_indices, num_indices, sizeof(uint32_t));
+        }
+
+        target->texcoords = array_hold(target->texcoords, num_indices, sizeof(tex2_packed_t));
+        target->texcoord_bits = array_hold(target->texcoord_bits, num_faces, sizeof(uint8_t));
+        target->normals = array_hold(target->normals, num_faces, sizeof(normal_packed_t));
+    }
+
+    for (int i = 0; i < num_faces; i++)
+    {
+        const face_t face = faces[i];
+        const int face_index = first_face + i;
+        const unsigned int indices[N_POINTS_TRIANGLE] = { face.a - 1, face.b - 1, face.c - 1 };
+        const tex2_t texcoords[N_POINTS_TRIANGLE] = { face.a_uv, face.b_uv, face.c_uv };
+
+        for (int j = 0; j < N_POINTS_TRIANGLE; j++)
+        {
+            if (quantizer->short_indices)
+            {
+                target->short_indices[(face_index * N_POINTS_TRIANGLE) + j] = (uint16_t)indices[j];
+            }
+            else
+            {
+                target->long_indices[(face_index * N_POINTS_TRIANGLE) + j] = (uint32_t)indices[j];
+            }
+        }
+
+        target->texcoord_bits[face_index] =
+            (uint8_t)pack_face_texcoords(texcoords, &target->texcoords[face_index * N_POINTS_TRIANGLE]);
+        target->normals[face_index] = normal_pack(normals[i]);
+    }
+}
+
+void free_quantized_mesh(mesh_quantized_t* target)
+{
+    array_free(target->positions);
+    array_free(target->short_indices);
+    array_free(target->long_indices);
+    array_free(target->texcoords);
+    array_free(target->texcoord_bits);
+    array_free(target->normals);
+    target->positions = NULL;
+    target->short_indices = NULL;
+    target->long_indices = NULL;
+    target->texcoords = NULL;
+    target->texcoord_bits = NULL;
+    target->normals = NULL;
+}
+
+void free_mesh_data(void)
+{
+    free_quantized_mesh(&mesh);
+}
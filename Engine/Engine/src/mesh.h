@@ -1,7 +1,11 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
 #include "vector.h"
+#include "matrix.h"
 #include "triangle.h"
 
 #pragma region Preprocessor directives
@@ -9,21 +13,304 @@
  * @brief The total number of vertices for our mesh. In this case the mesh is a cube so there are 8 vertices.
  */
 
-#define N_MESH_VERTICES 8
+#define N_CUBE_VERTICES 8
 /**
  * @brief The total number of triangle faces on our mesh. Cube has 6 faces, each face has 2 triangles each, total
  * of 12 faces.
  */
-#define N_MESH_FACES (6 * 2)
+#define N_CUBE_FACES (6 * 2)
+
+/**
+ * @brief Longest line we read from an OBJ file.
+ */
+#define OBJ_MAX_LINE_LENGTH 1024
+
+/**
+ * @brief Largest quantized position component, which maps to the upper bound of the mesh on that axis.
+ */
+#define MESH_POSITION_MAX UINT16_MAX
+
+/**
+ * @brief Largest vertex count whose indices fit in 16 bits.
+ */
+#define MESH_SHORT_INDEX_VERTICES (UINT16_MAX + 1)
+
+/**
+ * @brief An octahedral normal component of 1 in packed form.
+ */
+#define MESH_NORMAL_ONE INT16_MAX
 #pragma endregion
 
 /**
  * @brief Array of vertices that represents our cube.
  */
-extern vec3_t mesh_vertices[N_MESH_VERTICES];
+extern vec3_t cube_vertices[N_CUBE_VERTICES];
 
 /**
  * @brief Array of faces which contain the indices for each vertex that compose a single face.
  */
-extern face_t mesh_faces[N_MESH_FACES];
-#endif
\ No newline at end of file
+extern face_t cube_faces[N_CUBE_FACES];
+
+/**
+ * @brief A mesh made of dynamic arrays of vertices and faces. The loaders build meshes in this form, then quantize
+ * them into the global mesh.
+ */
+typedef struct
+{
+    /**
+     * @brief Dynamic array of vertices.
+     */
+    vec3_t* vertices;
+    /**
+     * @brief Dynamic array of faces which index into vertices.
+     */
+    face_t* faces;
+    /**
+     * @brief Dynamic array of unit face normals in model space, one per face. Computed once at load time.
+     */
+    vec3_t* normals;
+} mesh_t;
+
+/**
+ * @brief A position quantized to 16 bits per component, relative to the bounds of its mesh.
+ */
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t z;
+} vec3_quantized_t;
+
+/**
+ * @brief A unit normal in octahedral form: the normal projected onto the octahedron |x| + |y| + |z| = 1, with the
+ * lower half folded over the upper one, so two components are enough.
+ */
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+} normal_packed_t;
+
+/**
+ * @brief The compact form a mesh is kept in while it is rendered, about half the size of a mesh_t. Built from a
+ * mesh_t by quantize_mesh().
+ */
+typedef struct
+{
+    /**
+     * @brief Maps a quantized position to model space: scales by the size of one step and adds the lower bounds.
+     */
+    mat4_t dequantize;
+    /**
+     * @brief Dynamic array of quantized vertices.
+     */
+    vec3_quantized_t* positions;
+    /**
+     * @brief Dynamic array of three 0-based vertex indices per face, when the vertex count fits 16 bit indices.
+     * NULL otherwise.
+     */
+    uint16_t* short_indices;
+    /**
+     * @brief Dynamic array of three 0-based vertex indices per face, when short_indices is NULL.
+     */
+    uint32_t* long_indices;
+    /**
+     * @brief Dynamic array of three packed texture coordinates per face, as pack_face_texcoords() leaves them.
+     */
+    tex2_packed_t* texcoords;
+    /**
+     * @brief Dynamic array of the number of fractional bits of the packed texture coordinates, one per face.
+     */
+    uint8_t* texcoord_bits;
+    /**
+     * @brief Dynamic array of unit face normals in model space, one per face.
+     */
+    normal_packed_t* normals;
+} mesh_quantized_t;
+
+/**
+ * @brief Bounds of the positions of a mesh, grown as its vertices are seen.
+ */
+typedef struct
+{
+    /**
+     * @brief The smallest position component on each axis.
+     */
+    vec3_t lower;
+    /**
+     * @brief The largest position component on each axis.
+     */
+    vec3_t upper;
+    /**
+     * @brief Number of vertices seen so far. The bounds are meaningless while it is 0.
+     */
+    int num_vertices;
+} mesh_bounds_t;
+
+/**
+ * @brief Maps positions within the bounds of a whole mesh to quantized ones, so a mesh can be quantized in parts.
+ */
+typedef struct
+{
+    /**
+     * @brief The lower bounds of the mesh, which quantize to 0.
+     */
+    vec3_t lower;
+    /**
+     * @brief The size of one quantization step on each axis.
+     */
+    vec3_t step;
+    /**
+     * @brief Maps a quantized position back to model space.
+     */
+    mat4_t dequantize;
+    /**
+     * @brief True when the vertex count of the whole mesh fits 16 bit indices.
+     */
+    bool short_indices;
+} mesh_quantizer_t;
+
+/**
+ * @brief Incremental Wavefront OBJ parser state, fed one line at a time.
+ */
+typedef struct
+{
+    /**
+     * @brief Dynamic array receiving parsed vertices. The caller may take it and reset it to NULL at any time.
+     */
+    vec3_t* vertices;
+    /**
+     * @brief Dynamic array receiving parsed faces. The caller may take it and reset it to NULL at any time.
+     */
+    face_t* faces;
+    /**
+     * @brief Dynamic array of every texture coordinate parsed so far, used to resolve face corners.
+     */
+    tex2_t* texcoords;
+    /**
+     * @brief Total number of vertices parsed so far, including the ones already taken by the caller.
+     */
+    int vertex_count;
+} obj_parser_t;
+
+/**
+ * @brief The mesh that is rendered every frame.
+ */
+extern mesh_quantized_t mesh;
+
+/**
+ * @brief Replace a quantized mesh with the contents of a mesh. Positions keep 1/65535 of the size of the bounds on
+ * each axis, normals to within 0.05 degrees.
+ * @param target The quantized mesh to replace.
+ * @param source The mesh to quantize. Its normals must be computed.
+ */
+void quantize_mesh(mesh_quantized_t* target, const mesh_t* source);
+
+/**
+ * @brief Grow bounds to contain vertices.
+ * @param bounds The bounds to grow.
+ * @param vertices Dynamic array of vertices.
+ */
+void extend_mesh_bounds(mesh_bounds_t* bounds, const vec3_t* vertices);
+
+/**
+ * @brief Set up the quantization of a whole mesh.
+ * @param bounds The bounds of every vertex of the mesh.
+ * @return The quantizer for every part of the mesh.
+ */
+mesh_quantizer_t make_mesh_quantizer(const mesh_bounds_t* bounds);
+
+/**
+ * @brief Quantize part of a mesh and append it to a quantized mesh.
+ * @param target The quantized mesh to append to. Its index arrays must be of the width the quantizer picked.
+ * @param quantizer The quantizer of the whole mesh.
+ * @param vertices Dynamic array of the vertices of the part.
+ * @param faces Dynamic array of the faces of the part. Their indices count from the first vertex of the whole mesh.
+ * @param normals Dynamic array of the normals of the faces of the part.
+ */
+void quantize_mesh_part(mesh_quantized_t* target, const mesh_quantizer_t* quantizer, const vec3_t* vertices,
+    const face_t* faces, const vec3_t* normals);
+
+/**
+ * @brief Find a vertex of a face of a quantized mesh.
+ * @param source The quantized mesh.
+ * @param face The index of the face.
+ * @param corner The corner of the face, 0 to 2.
+ * @return The 0-based index of the vertex.
+ */
+static inline uint32_t mesh_vertex_index(const mesh_quantized_t* source, const int face, const int corner)
+{
+    const int index = (face * N_POINTS_TRIANGLE) + corner;
+
+    return source->short_indices ? source->short_indices[index] : source->long_indices[index];
+}
+
+/**
+ * @brief Unpack an octahedral normal.
+ * @param packed The packed normal.
+ * @return The unit normal.
+ */
+static inline vec3_t normal_unpack(const normal_packed_t packed)
+{
+    vec3_t normal = {
+        .x = (float)packed.x * (1.0f / MESH_NORMAL_ONE),
+        .y = (float)packed.y * (1.0f / MESH_NORMAL_ONE),
+        .z = 0.0f
+    };
+    normal.z = 1.0f - fabsf(normal.x) - fabsf(normal.y);
+
+    // Unfold the lower half of the octahedron.
+    const float fold = (normal.z < 0.0f) ? -normal.z : 0.0f;
+    normal.x += (normal.x >= 0.0f) ? -fold : fold;
+    normal.y += (normal.y >= 0.0f) ? -fold : fold;
+
+    const float inverse_length = 1.0f / sqrtf((normal.x * normal.x) + (normal.y * normal.y) + (normal.z * normal.z));
+    normal.x *= inverse_length;
+    normal.y *= inverse_length;
+    normal.z *= inverse_length;
+
+    return normal;
+}
+
+/**
+ * @brief Release the memory held by a quantized mesh.
+ * @param target The quantized mesh to free.
+ */
+void free_quantized_mesh(mesh_quantized_t* target);
+
+/**
+ * @brief Load the cube into the global mesh.
+ */
+void load_cube_mesh_data(void);
+
+/**
+ * @brief Parse one line of an OBJ file. Polygons are split into triangle fans, and faces that reference vertices not
+ * parsed yet are dropped.
+ * @param parser The parser state.
+ * @param line The line to parse.
+ */
+void obj_parse_line(obj_parser_t* parser, const char* line);
+
+/**
+ * @brief Release the memory held by a parser.
+ * @param parser The parser to free.
+ */
+void free_obj_parser(obj_parser_t* parser);
+
+/**
+ * @brief Compute the normals of the faces of a mesh that do not have one yet. Called by the loaders.
+ * @param target The mesh whose normals array is extended to match its faces array.
+ */
+void compute_mesh_normals(mesh_t* target);
+
+/**
+ * @brief Release the memory held by a mesh.
+ * @param target The mesh to free.
+ */
+void free_mesh(mesh_t* target);
+
+/**
+ * @brief Release the memory held by the global mesh.
+ */
+void free_mesh_data(void);
+#endif
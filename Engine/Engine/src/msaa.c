@@ -0,0 +1,153 @@
+#include <stdlib.h>
+#include "display.h"
+#include "msaa.h"
+
+/**
+ * @brief The samples of one partially covered pixel.
+ */
+typedef struct
+{
+    /**
+     * @brief Index of the pixel in the color buffer.
+     */
+    uint32_t pixel;
+    /**
+     * @brief The color of each sample.
+     */
+    uint32_t samples[MSAA_SAMPLES];
+} msaa_pixel_t;
+
+const int32_t msaa_sample_offsets[MSAA_SAMPLES][2] = {
+    { -2, -6 },
+    { 6, -2 },
+    { -6, 2 },
+    { 2, 6 }
+};
+
+uint32_t* msaa_slots = NULL;
+
+uint8_t* msaa_block_slots = NULL;
+
+int msaa_expanded_pixels = 0;
+
+/**
+ * @brief Samples of the partially covered pixels of this frame. Reset by every resolve, so only edge pixels ever take
+ * up sample storage.
+ */
+static msaa_pixel_t* sample_pool = NULL;
+
+/**
+ * @brief Number of entries sample_pool has room for.
+ */
+static int sample_pool_capacity = 0;
+
+bool msaa_resize(const int width, const int height)
+{
+    const size_t pixels = (size_t)width * height;
+    free(msaa_slots);
+    free(msaa_block_slots);
+    msaa_slots = (uint32_t*)calloc(pixels, sizeof(uint32_t));
+    msaa_block_slots = (uint8_t*)calloc((pixels >> MSAA_BLOCK_SHIFT) + 1, sizeof(uint8_t));
+    msaa_expanded_pixels = 0;
+
+    if (!msaa_slots || !msaa_block_slots)
+    {
+        free_msaa();
+        return false;
+    }
+
+    return true;
+}
+
+void msaa_store(const size_t pixel, const unsigned int mask, const uint32_t color)
+{
+    uint32_t slot = msaa_slots[pixel];
+
+    if (slot == 0)
+    {
+        if (msaa_expanded_pixels == sample_pool_capacity)
+        {
+            const int capacity = (sample_pool_capacity > 0) ? sample_pool_capacity * 2 : 1024;
+            msaa_pixel_t* pool = (msaa_pixel_t*)realloc(sample_pool, sizeof(msaa_pixel_t) * capacity);
+
+            // Out of memory: keep the pixel single color, taking the color if it covers at least half the samples.
+            if (!pool)
+            {
+                int covered = 0;
+
+                for (int s = 0; s < MSAA_SAMPLES; s++)
+                {
+                    covered += (mask >> s) & 1u;
+                }
+
+                color_buffer[pixel] = (covered * 2 >= MSAA_SAMPLES) ? color : color_buffer[pixel];
+                return;
+            }
+
+            sample_pool = pool;
+            sample_pool_capacity = capacity;
+        }
+
+        msaa_pixel_t* expanded = &sample_pool[msaa_expanded_pixels++];
+        expanded->pixel = (uint32_t)pixel;
+
+        for (int s = 0; s < MSAA_SAMPLES; s++)
+        {
+            expanded->samples[s] = color_buffer[pixel];
+        }
+
+        slot = (uint32_t)msaa_expanded_pixels;
+        msaa_slots[pixel] = slot;
+        msaa_block_slots[pixel >> MSAA_BLOCK_SHIFT]++;
+    }
+
+    uint32_t* samples = sample_pool[slot - 1].samples;
+
+    for (int s = 0; s < MSAA_SAMPLES; s++)
+    {
+        samples[s] = (mask & (1u << s)) ? color : samples[s];
+    }
+}
+
+void msaa_resolve(void)
+{
+    for (int i = 0; i < msaa_expanded_pixels; i++)
+    {
+        const msaa_pixel_t* expanded = &sample_pool[i];
+
+        // Pixels covered whole later in the frame went back to a single color and left this entry behind.
+        if (msaa_slots[expanded->pixel] != (uint32_t)i + 1)
+        {
+            continue;
+        }
+
+        // Average two channels per add, each sum of four fits in the 16 bits between them.
+        uint32_t red_blue = 0;
+        uint32_t alpha_green = 0;
+
+        for (int s = 0; s < MSAA_SAMPLES; s++)
+        {
+            red_blue += expanded->samples[s] & 0x00FF00FF;
+            alpha_green += (expanded->samples[s] >> 8) & 0x00FF00FF;
+        }
+
+        color_buffer[expanded->pixel] = ((red_blue / MSAA_SAMPLES) & 0x00FF00FF) |
+            (((alpha_green / MSAA_SAMPLES) & 0x00FF00FF) << 8);
+        msaa_slots[expanded->pixel] = 0;
+        msaa_block_slots[expanded->pixel >> MSAA_BLOCK_SHIFT] = 0;
+    }
+
+    msaa_expanded_pixels = 0;
+}
+
+void free_msaa(void)
+{
+    free(msaa_slots);
+    msaa_slots = NULL;
+    free(msaa_block_slots);
+    msaa_block_slots = NULL;
+    free(sample_pool);
+    sample_pool = NULL;
+    sample_pool_capacity = 0;
+    msaa_expanded_pixels = 0;
+}
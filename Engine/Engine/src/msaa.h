@@ -0,0 +1,126 @@
+#ifndef MSAA_H
+#define MSAA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#pragma region Preprocessor directives
+/**
+ * @brief Number of coverage samples per pixel.
+ */
+#define MSAA_SAMPLES 4
+
+/**
+ * @brief Coverage mask of a pixel whose samples are all covered.
+ */
+#define MSAA_FULL_MASK ((1u << MSAA_SAMPLES) - 1u)
+
+/**
+ * @brief Log2 of the number of consecutive pixels of the color buffer that share one count in msaa_block_slots.
+ */
+#define MSAA_BLOCK_SHIFT 5
+#pragma endregion
+
+/**
+ * @brief Position of each sample relative to the pixel center, in 1/SUBPIXEL_ONE pixels. A rotated grid, so
+ * horizontal and vertical edges each see four different sample positions.
+ */
+extern const int32_t msaa_sample_offsets[MSAA_SAMPLES][2];
+
+/**
+ * @brief Per pixel of the color buffer: 0 when the pixel holds a single color in the color buffer, otherwise 1 plus
+ * the index of its samples in the sample pool. NULL until msaa_resize() runs.
+ */
+extern uint32_t* msaa_slots;
+
+/**
+ * @brief Per block of 1 << MSAA_BLOCK_SHIFT consecutive pixels of the color buffer: number of pixels in the block whose
+ * slot is not 0. NULL until msaa_resize() runs.
+ */
+extern uint8_t* msaa_block_slots;
+
+/**
+ * @brief Number of pixels holding separate samples this frame.
+ */
+extern int msaa_expanded_pixels;
+
+/**
+ * @brief Size the per pixel slots for a color buffer.
+ * @param width The width of the color buffer in pixels.
+ * @param height The height of the color buffer in pixels.
+ * @return False if the slots could not be allocated.
+ */
+bool msaa_resize(const int width, const int height);
+
+/**
+ * @brief Write a color to the covered samples of a pixel. The pixel gets separate samples, initialized from its
+ * current color, the first time it is partially covered.
+ * @param pixel Index of the pixel in the color buffer.
+ * @param mask The covered samples, never 0 or MSAA_FULL_MASK.
+ * @param color An ARGB color value.
+ */
+void msaa_store(const size_t pixel, const unsigned int mask, const uint32_t color);
+
+/**
+ * @brief Average the samples of every pixel that has them into the color buffer, and return every pixel to a single
+ * color. Call once the frame is drawn, before it is presented.
+ */
+void msaa_resolve(void);
+
+/**
+ * @brief Release the slots and the sample pool.
+ */
+void free_msaa(void);
+
+/**
+ * @brief Return a run of pixels that was just written with one color per pixel to the single color form. Slots are
+ * only written in blocks that hold samples, and single pixels only when they hold samples themselves.
+ * @param pixel Index of the first pixel in the color buffer.
+ * @param count Number of pixels.
+ */
+static inline void msaa_flatten_span(const size_t pixel, const size_t count)
+{
+    // Nothing can have samples before the first partially covered pixel of the frame, or without slots at all.
+    if (msaa_expanded_pixels == 0)
+    {
+        return;
+    }
+
+    // Single pixels, from lines and fully covered edge pixels, are the common case and need no block walk.
+    if (count == 1)
+    {
+        if (msaa_slots[pixel] != 0)
+        {
+            msaa_slots[pixel] = 0;
+            msaa_block_slots[pixel >> MSAA_BLOCK_SHIFT]--;
+        }
+
+        return;
+    }
+
+    const size_t end = pixel + count;
+
+    for (size_t first = pixel; first < end;)
+    {
+        const size_t block = first >> MSAA_BLOCK_SHIFT;
+        const size_t block_end = ((block + 1) << MSAA_BLOCK_SHIFT) < end ? ((block + 1) << MSAA_BLOCK_SHIFT) : end;
+        unsigned int remaining = msaa_block_slots[block];
+
+        if (remaining > 0)
+        {
+            // Counted and cleared without branches so it vectorizes, edge pixels scatter samples unpredictably.
+            for (size_t i = first; i < block_end; i++)
+            {
+                remaining -= (msaa_slots[i] != 0);
+                msaa_slots[i] = 0;
+            }
+
+            msaa_block_slots[block] = (uint8_t)remaining;
+        }
+
+        first = block_end;
+    }
+}
+
+#endif
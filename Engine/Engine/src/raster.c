@@ -0,0 +1,584 @@
+#include <stdbool.h>
+#include <SDL.h>
+#include "display.h"
+#include "light.h"
+#include "msaa.h"
+#include "raster.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Defined when compiling for an x86 CPU, the only family with SIMD kernels so far.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RASTER_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Let a function use an instruction set the rest of the file is not compiled for. MSVC allows intrinsics
+ * anywhere, GCC and Clang need to be told per function.
+ */
+#if defined(__GNUC__)
+#define RASTER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RASTER_TARGET(isa)
+#endif
+
+/**
+ * @brief The target of kernels compiled for the instruction set the whole file is compiled for.
+ */
+#define RASTER_BASELINE
+
+/**
+ * @brief Force a function to be inlined, so constant arguments specialize its body at every call site.
+ */
+#if defined(_MSC_VER)
+#define RASTER_INLINE static __forceinline
+#else
+#define RASTER_INLINE static inline __attribute__((always_inline))
+#endif
+
+/**
+ * @brief Define a triangle fill kernel specialized for one combination of fill options, compiled with target.
+ */
+#define DEFINE_FILL_TRIANGLE_KERNEL(name, target, textured, shaded, multisampled) \
+    target static void name(const triangle_t* triangle, const texture_t* texture) \
+    {                                                                             \
+        fill_triangle_generic(triangle, texture, textured, shaded, multisampled); \
+    }
+
+/**
+ * @brief Define the triangle fill kernels of every combination of fill options for one instruction set.
+ */
+#define DEFINE_FILL_TRIANGLE_KERNELS(isa, target)                                                   \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_flat_##isa, target, false, false, false)              \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_textured_##isa, target, true, false, false)           \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_flat_shaded_##isa, target, false, true, false)        \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_textured_shaded_##isa, target, true, true, false)     \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_flat_msaa_##isa, target, false, false, true)          \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_textured_msaa_##isa, target, true, false, true)       \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_flat_shaded_msaa_##isa, target, false, true, true)    \
+    DEFINE_FILL_TRIANGLE_KERNEL(fill_triangle_textured_shaded_msaa_##isa, target, true, true, true)
+
+/**
+ * @brief Initializer of raster_kernels_t.fill_triangle with the kernels of one instruction set.
+ */
+#define FILL_TRIANGLE_KERNELS(isa) {                                                                              \
+        [0] = fill_triangle_flat_##isa,                                                                           \
+        [RASTER_FILL_TEXTURED] = fill_triangle_textured_##isa,                                                    \
+        [RASTER_FILL_SHADED] = fill_triangle_flat_shaded_##isa,                                                   \
+        [RASTER_FILL_TEXTURED | RASTER_FILL_SHADED] = fill_triangle_textured_shaded_##isa,                        \
+        [RASTER_FILL_MSAA] = fill_triangle_flat_msaa_##isa,                                                       \
+        [RASTER_FILL_MSAA | RASTER_FILL_TEXTURED] = fill_triangle_textured_msaa_##isa,                            \
+        [RASTER_FILL_MSAA | RASTER_FILL_SHADED] = fill_triangle_flat_shaded_msaa_##isa,                           \
+        [RASTER_FILL_MSAA | RASTER_FILL_TEXTURED | RASTER_FILL_SHADED] = fill_triangle_textured_shaded_msaa_##isa \
+    }
+#pragma endregion
+
+/**
+ * @brief One edge function of a triangle, in 1/(SUBPIXEL_ONE * SUBPIXEL_ONE) square pixels. It is zero on the edge
+ * and grows towards the opposite point, where it equals twice the area of the triangle.
+ */
+typedef struct
+{
+    /**
+     * @brief The value at the current pixel center, lowered by the bias.
+     */
+    int64_t value;
+    /**
+     * @brief How much the value changes from one pixel to the next.
+     */
+    int64_t step_x;
+    /**
+     * @brief How much the value changes from one row to the next.
+     */
+    int64_t step_y;
+    /**
+     * @brief 1 if pixel centers exactly on the edge belong to the neighbouring triangle, 0 otherwise.
+     */
+    int64_t bias;
+} edge_t;
+
+/**
+ * @brief Set up the edge function of the edge from a to b, evaluated at the pixel center (x, y).
+ * @param sign 1 or -1, so the value is positive inside the triangle whatever its winding.
+ */
+RASTER_INLINE edge_t setup_edge(const vec2_fixed_t a, const vec2_fixed_t b, const int32_t x, const int32_t y,
+    const int64_t sign)
+{
+    const int64_t delta_x = (int64_t)b.x - a.x;
+    const int64_t delta_y = (int64_t)b.y - a.y;
+
+    edge_t edge = {
+        .value = sign * ((delta_x * ((int64_t)y - a.y)) - (delta_y * ((int64_t)x - a.x))),
+        .step_x = sign * -delta_y * SUBPIXEL_ONE,
+        .step_y = sign * delta_x * SUBPIXEL_ONE,
+        .bias = 0
+    };
+
+    // Top-left rule: a center on a shared edge is drawn by exactly one of the two triangles. Left edges, and top
+    // edges that are horizontal, keep it.
+    const bool top_left = (edge.step_x > 0) || (edge.step_x == 0 && edge.step_y > 0);
+    edge.bias = top_left ? 0 : 1;
+    edge.value -= edge.bias;
+
+    return edge;
+}
+
+/**
+ * @brief Find the pixels of a row where all three edge functions are non-negative. Inside a triangle they always
+ * form a single run, so the fill loops never have to test coverage per pixel.
+ * @param edges The edges, with values at the first pixel of the row.
+ * @param width Number of pixels in the row.
+ * @param first Receives the offset of the first covered pixel.
+ * @param last Receives the offset of the last covered pixel.
+ * @return False if no pixel of the row is covered.
+ */
+RASTER_INLINE bool covered_span(const edge_t edges[3], const int width, int* first, int* last)
+{
+    int64_t low = 0;
+    int64_t high = width - 1;
+
+    for (int i = 0; i < 3; i++)
+    {
+        const int64_t value = edges[i].value;
+        const int64_t step = edges[i].step_x;
+
+        if (step > 0)
+        {
+            // First offset where value + step * offset >= 0.
+            if (value < 0)
+            {
+                const int64_t offset = (-value + step - 1) / step;
+                low = (offset > low) ? offset : low;
+            }
+        }
+        else if (step < 0)
+        {
+            // Last offset where value + step * offset >= 0.
+            if (value < 0)
+            {
+                return false;
+            }
+
+            const int64_t offset = value / -step;
+            high = (offset < high) ? offset : high;
+        }
+        else if (value < 0)
+        {
+            return false;
+        }
+    }
+
+    if (low > high)
+    {
+        return false;
+    }
+
+    *first = (int)low;
+    *last = (int)high;
+    return true;
+}
+
+/**
+ * @brief What a triangle needs to shade one of its pixels.
+ */
+typedef struct
+{
+    /**
+     * @brief The color of flat fills, already lit when shaded.
+     */
+    uint32_t flat_color;
+    /**
+     * @brief The light level of shaded fills.
+     */
+    int light_level;
+    /**
+     * @brief The mip level textured fills sample.
+     */
+    const texture_level_t* level;
+    /**
+     * @brief 1/z at each point.
+     */
+    float w[3];
+    /**
+     * @brief u/z at each point.
+     */
+    float u[3];
+    /**
+     * @brief v/z at each point.
+     */
+    float v[3];
+} shading_t;
+
+/**
+ * @brief Shade one pixel from the barycentric weights of its first two points.
+ */
+RASTER_INLINE uint32_t shade_pixel(const shading_t* shading, const float b0, const float b1, const bool textured,
+    const bool shaded)
+{
+    if (!textured)
+    {
+        return shading->flat_color;
+    }
+
+    const float b2 = 1.0f - b0 - b1;
+    const float depth = 1.0f / ((b0 * shading->w[0]) + (b1 * shading->w[1]) + (b2 * shading->w[2]));
+    const float texel_u = ((b0 * shading->u[0]) + (b1 * shading->u[1]) + (b2 * shading->u[2])) * depth;
+    const float texel_v = ((b0 * shading->v[0]) + (b1 * shading->v[1]) + (b2 * shading->v[2])) * depth;
+    const uint32_t texel = texture_sample(shading->level, texel_u, texel_v);
+
+    return shaded ? light_apply_level(texel, shading->light_level) : texel;
+}
+
+/**
+ * @brief Copy the edges with each value moved to its best or worst sample, for the spans where some or all samples
+ * of a pixel are covered.
+ */
+RASTER_INLINE void offset_edges(const edge_t edges[3], const int64_t offsets[3][MSAA_SAMPLES], const bool best,
+    edge_t moved[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t offset = offsets[i][0];
+
+        for (int s = 1; s < MSAA_SAMPLES; s++)
+        {
+            offset = best ? SDL_max(offset, offsets[i][s]) : SDL_min(offset, offsets[i][s]);
+        }
+
+        moved[i] = edges[i];
+        moved[i].value += offset;
+    }
+}
+
+/**
+ * @brief Fill a triangle. Every caller passes constant options, so each kernel only keeps the code it needs.
+ */
+RASTER_INLINE void fill_triangle_generic(const triangle_t* triangle, const texture_t* texture, const bool textured,
+    const bool shaded, const bool multisampled)
+{
+    const vec2_fixed_t p0 = triangle->points[0];
+    const vec2_fixed_t p1 = triangle->points[1];
+    const vec2_fixed_t p2 = triangle->points[2];
+
+    // Twice the signed area in 1/(SUBPIXEL_ONE * SUBPIXEL_ONE) square pixels. Exact, so degenerate triangles are
+    // always rejected.
+    const int64_t area = (((int64_t)p1.x - p0.x) * ((int64_t)p2.y - p0.y)) -
+        (((int64_t)p1.y - p0.y) * ((int64_t)p2.x - p0.x));
+
+    if (area == 0 || (textured && texture->mip_levels == 0) || (multisampled && !msaa_slots))
+    {
+        return;
+    }
+
+    // Bounding box of the pixel centers the triangle can cover, clipped to the screen. Samples sit less than half a
+    // pixel from the center, so with multisampling one more pixel on each side may be touched.
+    const int32_t half_pixel = SUBPIXEL_ONE / 2;
+    const int margin = multisampled ? 1 : 0;
+    int min_x = ((SDL_min(p0.x, SDL_min(p1.x, p2.x)) - half_pixel + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS) - margin;
+    int min_y = ((SDL_min(p0.y, SDL_min(p1.y, p2.y)) - half_pixel + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS) - margin;
+    int max_x = ((SDL_max(p0.x, SDL_max(p1.x, p2.x)) - half_pixel) >> SUBPIXEL_BITS) + margin;
+    int max_y = ((SDL_max(p0.y, SDL_max(p1.y, p2.y)) - half_pixel) >> SUBPIXEL_BITS) + margin;
+
+    min_x = (min_x < 0) ? 0 : min_x;
+    min_y = (min_y < 0) ? 0 : min_y;
+    max_x = (max_x > window_width - 1) ? window_width - 1 : max_x;
+    max_y = (max_y > window_height - 1) ? window_height - 1 : max_y;
+
+    if (min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+
+    const int width = max_x - min_x + 1;
+
+    // Edge functions at the first pixel center. Edge i is opposite point i, so divided by the area it is the
+    // barycentric weight of point i.
+    const int64_t sign = (area > 0) ? 1 : -1;
+    const int32_t start_x = (min_x << SUBPIXEL_BITS) + half_pixel;
+    const int32_t start_y = (min_y << SUBPIXEL_BITS) + half_pixel;
+    edge_t edges[3] = {
+        setup_edge(p1, p2, start_x, start_y, sign),
+        setup_edge(p2, p0, start_x, start_y, sign),
+        setup_edge(p0, p1, start_x, start_y, sign)
+    };
+
+    // How much each edge function differs between the pixel center and each sample. The steps are whole pixels,
+    // the offsets 1/SUBPIXEL_ONE pixels, so the division is exact.
+    int64_t sample_offsets[3][MSAA_SAMPLES];
+
+    if (multisampled)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int s = 0; s < MSAA_SAMPLES; s++)
+            {
+                sample_offsets[i][s] = ((edges[i].step_x * msaa_sample_offsets[s][0]) +
+                    (edges[i].step_y * msaa_sample_offsets[s][1])) / SUBPIXEL_ONE;
+            }
+        }
+    }
+
+    // Textured fills interpolate u/z, v/z and 1/z, which are linear in screen space, and use one mip level. Flat
+    // fills use one color for the whole triangle.
+    shading_t shading = {
+        .flat_color = shaded ? light_apply_level(triangle->color, triangle->light_level) : triangle->color,
+        .light_level = triangle->light_level,
+        .level = NULL
+    };
+    float inv_area = 0.0f;
+
+    if (textured)
+    {
+        const tex2_t t0 = triangle_texcoord(triangle, 0);
+        const tex2_t t1 = triangle_texcoord(triangle, 1);
+        const tex2_t t2 = triangle_texcoord(triangle, 2);
+        const float uv_area = ((t1.u - t0.u) * (t2.v - t0.v)) - ((t1.v - t0.v) * (t2.u - t0.u));
+        const float screen_area = (float)area * (1.0f / (SUBPIXEL_ONE * SUBPIXEL_ONE));
+        shading.level = &texture->levels[texture_select_mip_level(texture, uv_area, screen_area)];
+        inv_area = 1.0f / (float)(sign * area);
+
+        for (int i = 0; i < 3; i++)
+        {
+            const tex2_t texcoord = triangle_texcoord(triangle, i);
+            shading.w[i] = triangle->inv_depths[i];
+            shading.u[i] = texcoord.u * shading.w[i];
+            shading.v[i] = texcoord.v * shading.w[i];
+        }
+    }
+
+    for (int y = min_y; y <= max_y; y++)
+    {
+        const size_t row = ((size_t)window_width * y) + min_x;
+        uint32_t* pixels = &color_buffer[row];
+
+        // Pixels with every sample covered. Without multisampling, the pixels with their center covered.
+        int first = 0;
+        int last = -1;
+        edge_t inner_edges[3];
+
+        if (multisampled)
+        {
+            offset_edges(edges, sample_offsets, false, inner_edges);
+        }
+
+        if (!covered_span(multisampled ? inner_edges : edges, width, &first, &last))
+        {
+            first = width;
+            last = width - 1;
+        }
+
+        if (first <= last)
+        {
+            if (!textured)
+            {
+                raster_kernels.fill_span(pixels + first, (size_t)(last - first + 1), shading.flat_color);
+            }
+            else
+            {
+                // Only the attribute interpolation is done in floating point.
+                float b0 = (float)(edges[0].value + edges[0].bias + (edges[0].step_x * first)) * inv_area;
+                float b1 = (float)(edges[1].value + edges[1].bias + (edges[1].step_x * first)) * inv_area;
+                const float step_b0 = (float)edges[0].step_x * inv_area;
+                const float step_b1 = (float)edges[1].step_x * inv_area;
+
+                for (int x = first; x <= last; x++)
+                {
+                    pixels[x] = shade_pixel(&shading, b0, b1, textured, shaded);
+                    b0 += step_b0;
+                    b1 += step_b1;
+                }
+            }
+
+            if (multisampled)
+            {
+                msaa_flatten_span(row + first, (size_t)(last - first + 1));
+            }
+        }
+
+        // Pixels with only some samples covered lie between the full span and the span where any sample may be.
+        // They get a coverage mask, one color shaded at the center, and separate samples.
+        edge_t outer_edges[3];
+        int outer_first = 0;
+        int outer_last = 0;
+
+        if (multisampled)
+        {
+            offset_edges(edges, sample_offsets, true, outer_edges);
+        }
+
+        if (multisampled && covered_span(outer_edges, width, &outer_first, &outer_last))
+        {
+            for (int x = outer_first; x <= outer_last; x++)
+            {
+                if (x == first && last >= first)
+                {
+                    x = last;
+                    continue;
+                }
+
+                // A sample is covered when all three edge functions are non-negative there. The sign bits are
+                // combined without branches, since which samples an edge pixel covers is unpredictable.
+                unsigned int mask = MSAA_FULL_MASK;
+
+                for (int i = 0; i < 3; i++)
+                {
+                    const int64_t value = edges[i].value + (edges[i].step_x * x);
+
+                    for (int s = 0; s < MSAA_SAMPLES; s++)
+                    {
+                        mask &= ~((unsigned int)((uint64_t)(value + sample_offsets[i][s]) >> 63) << s);
+                    }
+                }
+
+                if (mask == 0)
+                {
+                    continue;
+                }
+
+                const float b0 = textured ?
+                    (float)(edges[0].value + edges[0].bias + (edges[0].step_x * x)) * inv_area : 0.0f;
+                const float b1 = textured ?
+                    (float)(edges[1].value + edges[1].bias + (edges[1].step_x * x)) * inv_area : 0.0f;
+                const uint32_t color = shade_pixel(&shading, b0, b1, textured, shaded);
+
+                if (mask == MSAA_FULL_MASK)
+                {
+                    pixels[x] = color;
+                    msaa_flatten_span(row + x, 1);
+                }
+                else
+                {
+                    msaa_store(row + x, mask, color);
+                }
+            }
+        }
+
+        edges[0].value += edges[0].step_y;
+        edges[1].value += edges[1].step_y;
+        edges[2].value += edges[2].step_y;
+    }
+}
+
+DEFINE_FILL_TRIANGLE_KERNELS(scalar, RASTER_BASELINE)
+
+/**
+ * @brief Portable span fill.
+ */
+static void fill_span_scalar(uint32_t* pixels, const size_t count, const uint32_t color)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        pixels[i] = color;
+    }
+}
+
+#ifdef RASTER_X86
+/**
+ * @brief Span fill storing 4 pixels at a time.
+ */
+RASTER_TARGET("sse2") static void fill_span_sse2(uint32_t* pixels, const size_t count, const uint32_t color)
+{
+    const __m128i colors = _mm_set1_epi32((int)color);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_si128((__m128i*)(pixels + i), colors);
+    }
+
+    for (; i < count; i++)
+    {
+        pixels[i] = color;
+    }
+}
+
+/**
+ * @brief Span fill storing 8 pixels at a time.
+ */
+RASTER_TARGET("avx2") static void fill_span_avx2(uint32_t* pixels, const size_t count, const uint32_t color)
+{
+    const __m256i colors = _mm256_set1_epi32((int)color);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_si256((__m256i*)(pixels + i), colors);
+    }
+
+    for (; i < count; i++)
+    {
+        pixels[i] = color;
+    }
+}
+
+/**
+ * @brief Span fill storing 16 pixels at a time, with a masked store for the tail.
+ */
+RASTER_TARGET("avx512f") static void fill_span_avx512(uint32_t* pixels, const size_t count, const uint32_t color)
+{
+    const __m512i colors = _mm512_set1_epi32((int)color);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        _mm512_storeu_si512((void*)(pixels + i), colors);
+    }
+
+    if (i < count)
+    {
+        const __mmask16 tail = (__mmask16)((1u << (count - i)) - 1u);
+        _mm512_mask_storeu_epi32((void*)(pixels + i), tail, colors);
+    }
+}
+
+// The triangle fills again, with the compiler free to use each instruction set in their interpolation and sampling.
+DEFINE_FILL_TRIANGLE_KERNELS(sse2, RASTER_TARGET("sse2"))
+DEFINE_FILL_TRIANGLE_KERNELS(avx2, RASTER_TARGET("avx2"))
+
+/**
+ * @brief The kernels of each instruction set, best first.
+ */
+static const raster_kernels_t raster_kernels_avx512 = {
+    .isa_name = "AVX-512",
+    .fill_span = fill_span_avx512,
+    // Built for AVX-512, the triangle fills measured about 20% slower than the AVX2 ones on the stress scene. Their
+    // per pixel math is scalar, and using the upper registers only costs clock speed.
+    .fill_triangle = FILL_TRIANGLE_KERNELS(avx2)
+};
+static const raster_kernels_t raster_kernels_avx2 = {
+    .isa_name = "AVX2",
+    .fill_span = fill_span_avx2,
+    .fill_triangle = FILL_TRIANGLE_KERNELS(avx2)
+};
+static const raster_kernels_t raster_kernels_sse2 = {
+    .isa_name = "SSE2",
+    .fill_span = fill_span_sse2,
+    .fill_triangle = FILL_TRIANGLE_KERNELS(sse2)
+};
+#endif
+
+raster_kernels_t raster_kernels = {
+    .isa_name = "scalar",
+    .fill_span = fill_span_scalar,
+    .fill_triangle = FILL_TRIANGLE_KERNELS(scalar)
+};
+
+void select_raster_kernels(void)
+{
+#ifdef RASTER_X86
+    if (SDL_HasAVX512F())
+    {
+        raster_kernels = raster_kernels_avx512;
+    }
+    else if (SDL_HasAVX2())
+    {
+        raster_kernels = raster_kernels_avx2;
+    }
+    else if (SDL_HasSSE2())
+    {
+        raster_kernels = raster_kernels_sse2;
+    }
+#endif
+}
@@ -0,0 +1,70 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "triangle.h"
+#include "texture.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Fill kernel index bit: the triangle samples the texture instead of using its flat color.
+ */
+#define RASTER_FILL_TEXTURED 1
+
+/**
+ * @brief Fill kernel index bit: the fill is modulated by the light level of the triangle.
+ */
+#define RASTER_FILL_SHADED 2
+
+/**
+ * @brief Fill kernel index bit: edge pixels get a 4 sample coverage mask, see msaa.h.
+ */
+#define RASTER_FILL_MSAA 4
+
+/**
+ * @brief Number of fill kernels, one per combination of RASTER_FILL bits.
+ */
+#define RASTER_FILL_KERNELS 8
+#pragma endregion
+
+/**
+ * @brief Fill count 32-bit pixels with the same color.
+ */
+typedef void (*fill_span_kernel_t)(uint32_t* pixels, const size_t count, const uint32_t color);
+
+/**
+ * @brief Fill a projected triangle into the color buffer.
+ */
+typedef void (*fill_triangle_kernel_t)(const triangle_t* triangle, const texture_t* texture);
+
+/**
+ * @brief The kernels picked for the CPU the engine runs on.
+ */
+typedef struct
+{
+    /**
+     * @brief Name of the instruction set the kernels were picked for.
+     */
+    const char* isa_name;
+    /**
+     * @brief Fill a run of pixels with one color. Used to clear the color buffer and by the flat fills.
+     */
+    fill_span_kernel_t fill_span;
+    /**
+     * @brief Triangle fill kernels, indexed by a combination of RASTER_FILL bits.
+     */
+    fill_triangle_kernel_t fill_triangle[RASTER_FILL_KERNELS];
+} raster_kernels_t;
+
+/**
+ * @brief The kernels in use. Scalar until select_raster_kernels() runs.
+ */
+extern raster_kernels_t raster_kernels;
+
+/**
+ * @brief Pick the fastest kernels the CPU supports. Call once at startup, before drawing anything.
+ */
+void select_raster_kernels(void);
+
+#endif
@@ -0,0 +1,443 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/array.h"
+#include "replay.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief First line of a script file.
+ */
+#define REPLAY_SCRIPT_HEADER "replay-script 1"
+
+/**
+ * @brief Longest line read from a script or a timings file.
+ */
+#define REPLAY_MAX_LINE_LENGTH 512
+
+/**
+ * @brief Distance from the camera to the mesh on the built-in path.
+ */
+#define REPLAY_CAMERA_DISTANCE 5.0f
+
+/**
+ * @brief Error message for when a file cannot be opened.
+ */
+#define REPLAY_OPEN_ERR "Error opening %s.\n"
+
+/**
+ * @brief Error message for when a script holds no frames.
+ */
+#define REPLAY_EMPTY_ERR "Script %s holds no frames.\n"
+#pragma endregion
+
+/**
+ * @brief Dynamic array of the frames of the script being played.
+ */
+static replay_frame_t* script_frames = NULL;
+
+/**
+ * @brief Index of the next frame to play.
+ */
+static int next_frame = 0;
+
+/**
+ * @brief The script being recorded, or NULL.
+ */
+static FILE* record_file = NULL;
+
+/**
+ * @brief Dynamic array of the time of every frame, in milliseconds.
+ */
+static double* frame_times = NULL;
+
+bool parse_replay_options(const int argc, char* argv[], replay_options_t* options)
+{
+    bool scripted = false;
+
+    options->replay_file = NULL;
+    options->record_file = NULL;
+    options->frames = REPLAY_DEFAULT_FRAMES;
+    options->timings_file = NULL;
+    options->baseline_file = NULL;
+    options->width = REPLAY_DEFAULT_WIDTH;
+    options->height = REPLAY_DEFAULT_HEIGHT;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            options->replay_file = argv[++i];
+            scripted = true;
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            options->record_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            options->frames = atoi(argv[++i]);
+            scripted = true;
+        }
+        else if (strcmp(argv[i], "--timings") == 0 && i + 1 < argc)
+        {
+            options->timings_file = argv[++i];
+            scripted = true;
+        }
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+        {
+            options->baseline_file = argv[++i];
+            scripted = true;
+        }
+        else if (strcmp(argv[i], "--resolution") == 0 && i + 1 < argc)
+        {
+            int width = 0;
+            int height = 0;
+
+            if (sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0)
+            {
+                options->width = width;
+                options->height = height;
+            }
+        }
+    }
+
+    options->frames = (options->frames > 0) ? options->frames : REPLAY_DEFAULT_FRAMES;
+
+    return scripted;
+}
+
+bool replay_load(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+
+    if (!file)
+    {
+        int _ = fprintf(stderr, REPLAY_OPEN_ERR, filename);
+        return false;
+    }
+
+    array_free(script_frames);
+    script_frames = NULL;
+    next_frame = 0;
+
+    char line[REPLAY_MAX_LINE_LENGTH];
+
+    while (fgets(line, REPLAY_MAX_LINE_LENGTH, file))
+    {
+        replay_frame_t frame;
+
+        // Anything that is not a full frame, like the header, is skipped.
+        const int read = sscanf(line, "%f %f %f %f %f %f %f %f %f %f %f %f",
+            &frame.camera_translation.x, &frame.camera_translation.y, &frame.camera_translation.z,
+            &frame.camera_rotation.x, &frame.camera_rotation.y, &frame.camera_rotation.z,
+            &frame.mesh_translation.x, &frame.mesh_translation.y, &frame.mesh_translation.z,
+            &frame.mesh_rotation.x, &frame.mesh_rotation.y, &frame.mesh_rotation.z);
+
+        if (read == 12)
+        {
+            array_push(script_frames, frame);
+        }
+    }
+
+    int _ = fclose(file);
+
+    if (!script_frames)
+    {
+        int _ = fprintf(stderr, REPLAY_EMPTY_ERR, filename);
+        return false;
+    }
+
+    return true;
+}
+
+void replay_generate(const int frames)
+{
+    array_free(script_frames);
+    script_frames = NULL;
+    next_frame = 0;
+
+    for (int i = 0; i < frames; i++)
+    {
+        const float t = (float)i / 60.0f;
+
+        // The camera node holds the inverse of the camera position. Rotations away from the view axis stay small, so
+        // nothing swings behind the camera.
+        const replay_frame_t frame = {
+            .camera_translation = {
+                -0.5f * sinf(0.7f * t),
+                -0.3f * sinf(0.5f * t),
+                REPLAY_CAMERA_DISTANCE + sinf(0.3f * t)
+            },
+            .camera_rotation = { 0.0f, 0.0f, 0.0f },
+            .mesh_translation = { 0.0f, 0.0f, 0.0f },
+            .mesh_rotation = { 0.02f * sinf(0.9f * t), 0.02f * sinf(1.1f * t), 0.2f * t }
+        };
+
+        array_push(script_frames, frame);
+    }
+}
+
+bool replay_is_playing(void)
+{
+    return script_frames != NULL;
+}
+
+int replay_frame_count(void)
+{
+    return array_length(script_frames);
+}
+
+bool replay_next(replay_frame_t* frame)
+{
+    if (next_frame >= array_length(script_frames))
+    {
+        return false;
+    }
+
+    *frame = script_frames[next_frame++];
+    return true;
+}
+
+void replay_rewind(void)
+{
+    next_frame = 0;
+    array_free(frame_times);
+    frame_times = NULL;
+}
+
+bool replay_record_start(const char* filename)
+{
+    if (record_file)
+    {
+        int _ = fclose(record_file);
+    }
+
+    record_file = fopen(filename, "w");
+
+    if (!record_file)
+    {
+        int _ = fprintf(stderr, REPLAY_OPEN_ERR, filename);
+        return false;
+    }
+
+    int _ = fprintf(record_file, "%s\n", REPLAY_SCRIPT_HEADER);
+    return true;
+}
+
+void replay_record(const replay_frame_t* frame)
+{
+    if (!record_file)
+    {
+        return;
+    }
+
+    // Nine significant digits read back to the same float, so a replay is exact.
+    int _ = fprintf(record_file, "%.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n",
+        frame->camera_translation.x, frame->camera_translation.y, frame->camera_translation.z,
+        frame->camera_rotation.x, frame->camera_rotation.y, frame->camera_rotation.z,
+        frame->mesh_translation.x, frame->mesh_translation.y, frame->mesh_translation.z,
+        frame->mesh_rotation.x, frame->mesh_rotation.y, frame->mesh_rotation.z);
+}
+
+void replay_time_frame(const double milliseconds)
+{
+    array_push(frame_times, milliseconds);
+}
+
+/**
+ * @brief Order doubles ascending for qsort.
+ */
+static int compare_doubles(const void* a, const void* b)
+{
+    const double value_a = *(const double*)a;
+    const double value_b = *(const double*)b;
+
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+/**
+ * @brief Read the milliseconds column of a timings file.
+ * @return A dynamic array of frame times, or NULL if the file could not be read.
+ */
+static double* load_timings(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+
+    if (!file)
+    {
+        int _ = fprintf(stderr, REPLAY_OPEN_ERR, filename);
+        return NULL;
+    }
+
+    double* times = NULL;
+    char line[REPLAY_MAX_LINE_LENGTH];
+
+    while (fgets(line, REPLAY_MAX_LINE_LENGTH, file))
+    {
+        int frame = 0;
+        double milliseconds = 0.0;
+
+        // The header does not parse and is skipped.
+        if (sscanf(line, "%d,%lf", &frame, &milliseconds) == 2)
+        {
+            array_push(times, milliseconds);
+        }
+    }
+
+    int _ = fclose(file);
+    return times;
+}
+
+/**
+ * @brief Print the mean, median, 95th percentile and maximum of a set of values.
+ */
+static void print_distribution(const char* name, const double* values, const int count)
+{
+    double* sorted = (double*)malloc(sizeof(double) * count);
+
+    if (!sorted || count == 0)
+    {
+        free(sorted);
+        return;
+    }
+
+    double sum = 0.0;
+
+    for (int i = 0; i < count; i++)
+    {
+        sorted[i] = values[i];
+        sum += values[i];
+    }
+
+    qsort(sorted, count, sizeof(double), compare_doubles);
+
+    printf("%-20s mean %8.3f  median %8.3f  p95 %8.3f  max %8.3f ms\n", name, sum / count, sorted[count / 2],
+        sorted[(count * 95) / 100], sorted[count - 1]);
+
+    free(sorted);
+}
+
+bool replay_report(const replay_options_t* options)
+{
+    const int count = array_length(frame_times);
+
+    if (count == 0)
+    {
+        return true;
+    }
+
+    printf("%-20s %d frames\n", "replay", count);
+    print_distribution("frame time", frame_times, count);
+
+    // Per-frame differences against an earlier run of the same script.
+    double* baseline = NULL;
+    double* deltas = NULL;
+    int compared = 0;
+    int previous_worst = -1;
+    double previous_worst_delta = 0.0;
+    bool succeeded = true;
+
+    if (options->baseline_file)
+    {
+        baseline = load_timings(options->baseline_file);
+        succeeded = baseline != NULL;
+        compared = (count < array_length(baseline)) ? count : array_length(baseline);
+    }
+
+    if (compared > 0)
+    {
+        deltas = (double*)malloc(sizeof(double) * compared);
+    }
+
+    if (deltas)
+    {
+        double baseline_sum = 0.0;
+        double current_sum = 0.0;
+
+        for (int i = 0; i < compared; i++)
+        {
+            deltas[i] = frame_times[i] - baseline[i];
+            baseline_sum += baseline[i];
+            current_sum += frame_times[i];
+        }
+
+        print_distribution("baseline", baseline, compared);
+        print_distribution("delta", deltas, compared);
+        printf("%-20s %+.1f%% over %d frames\n", "change", 100.0 * (current_sum - baseline_sum) / baseline_sum,
+            compared);
+
+        // The frames that slowed down the most, largest first.
+        for (int i = 0; i < REPLAY_WORST_FRAMES && i < compared; i++)
+        {
+            int worst = -1;
+
+            for (int j = 0; j < compared; j++)
+            {
+                const bool listed = (i > 0) && (deltas[j] > previous_worst_delta ||
+                    (deltas[j] == previous_worst_delta && j <= previous_worst));
+
+                if (!listed && (worst < 0 || deltas[j] > deltas[worst]))
+                {
+                    worst = j;
+                }
+            }
+
+            printf("%-20s frame %5d  %8.3f -> %8.3f ms (%+.3f)\n", (i == 0) ? "largest regressions" : "",
+                worst, baseline[worst], frame_times[worst], deltas[worst]);
+            previous_worst = worst;
+            previous_worst_delta = deltas[worst];
+        }
+    }
+
+    if (options->timings_file)
+    {
+        FILE* file = fopen(options->timings_file, "w");
+
+        if (!file)
+        {
+            int _ = fprintf(stderr, REPLAY_OPEN_ERR, options->timings_file);
+            succeeded = false;
+        }
+        else
+        {
+            int _ = fprintf(file, deltas ? "frame,milliseconds,baseline,delta\n" : "frame,milliseconds\n");
+
+            for (int i = 0; i < count; i++)
+            {
+                if (deltas && i < compared)
+                {
+                    _ = fprintf(file, "%d,%.6f,%.6f,%+.6f\n", i, frame_times[i], baseline[i], deltas[i]);
+                }
+                else
+                {
+                    _ = fprintf(file, "%d,%.6f\n", i, frame_times[i]);
+                }
+            }
+
+            _ = fclose(file);
+        }
+    }
+
+    free(deltas);
+    array_free(baseline);
+
+    return succeeded;
+}
+
+void free_replay(void)
+{
+    if (record_file)
+    {
+        int _ = fclose(record_file);
+        record_file = NULL;
+    }
+
+    array_free(script_frames);
+    script_frames = NULL;
+    array_free(frame_times);
+    frame_times = NULL;
+    next_frame = 0;
+}
@@ -0,0 +1,162 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include "vector.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Length of the built-in camera path, in frames.
+ */
+#define REPLAY_DEFAULT_FRAMES 300
+
+/**
+ * @brief Default width of a headless scripted run.
+ */
+#define REPLAY_DEFAULT_WIDTH 1280
+
+/**
+ * @brief Default height of a headless scripted run.
+ */
+#define REPLAY_DEFAULT_HEIGHT 720
+
+/**
+ * @brief Number of slowest frames listed when comparing timings.
+ */
+#define REPLAY_WORST_FRAMES 5
+#pragma endregion
+
+/**
+ * @brief The transforms driving one frame of a script.
+ */
+typedef struct
+{
+    /**
+     * @brief Translation of the camera node.
+     */
+    vec3_t camera_translation;
+    /**
+     * @brief Rotation of the camera node.
+     */
+    vec3_t camera_rotation;
+    /**
+     * @brief Translation of the mesh node.
+     */
+    vec3_t mesh_translation;
+    /**
+     * @brief Rotation of the mesh node.
+     */
+    vec3_t mesh_rotation;
+} replay_frame_t;
+
+/**
+ * @brief Options of a scripted run, parsed from the command line.
+ */
+typedef struct
+{
+    /**
+     * @brief Script to replay, or NULL. Set by --replay <file>.
+     */
+    const char* replay_file;
+    /**
+     * @brief Where to record the transforms of every frame, or NULL. Set by --record <file>.
+     */
+    const char* record_file;
+    /**
+     * @brief Length of the built-in camera path. Set by --frames <n>.
+     */
+    int frames;
+    /**
+     * @brief Where to write the time of every frame, or NULL. Set by --timings <file>.
+     */
+    const char* timings_file;
+    /**
+     * @brief Timings of an earlier run to compare against, or NULL. Set by --baseline <file>.
+     */
+    const char* baseline_file;
+    /**
+     * @brief Width of a headless scripted run. Set by --resolution <width>x<height>.
+     */
+    int width;
+    /**
+     * @brief Height of a headless scripted run. Set by --resolution <width>x<height>.
+     */
+    int height;
+} replay_options_t;
+
+/**
+ * @brief Parse the scripted run options out of the command line.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @param options Receives the options.
+ * @return True if any scripted run option was given.
+ */
+bool parse_replay_options(const int argc, char* argv[], replay_options_t* options);
+
+/**
+ * @brief Load a script recorded with replay_record_start().
+ * @param filename Path of the script.
+ * @return False if the file could not be read or holds no frames.
+ */
+bool replay_load(const char* filename);
+
+/**
+ * @brief Use the built-in camera path: a slow pan and dolly over a mesh turning around the view axis.
+ * @param frames Length of the path in frames.
+ */
+void replay_generate(const int frames);
+
+/**
+ * @brief Whether a script is being played.
+ */
+bool replay_is_playing(void);
+
+/**
+ * @brief The number of frames in the script being played.
+ */
+int replay_frame_count(void);
+
+/**
+ * @brief Get the transforms of the next frame of the script.
+ * @param frame Receives the transforms.
+ * @return False once every frame has been played.
+ */
+bool replay_next(replay_frame_t* frame);
+
+/**
+ * @brief Go back to the first frame of the script and forget the frame times.
+ */
+void replay_rewind(void);
+
+/**
+ * @brief Start recording the transforms of every frame.
+ * @param filename Path of the script to write.
+ * @return False if the file could not be created.
+ */
+bool replay_record_start(const char* filename);
+
+/**
+ * @brief Record the transforms of one frame, if recording.
+ * @param frame The transforms.
+ */
+void replay_record(const replay_frame_t* frame);
+
+/**
+ * @brief Remember how long a frame took.
+ * @param milliseconds The time spent on the frame.
+ */
+void replay_time_frame(const double milliseconds);
+
+/**
+ * @brief Print a summary of the frame times, write them if asked to and compare them with the baseline.
+ * @param options The scripted run options.
+ * @return False if a file could not be read or written.
+ */
+bool replay_report(const replay_options_t* options);
+
+/**
+ * @brief Stop recording and release the script and the frame times.
+ */
+void free_replay(void);
+
+#endif
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include "../include/array.h"
+#include "scene.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Error message for when a node would break the depth-first order of the scene.
+ */
+#define SCENE_PARENT_ERR "Scene node %d cannot take new children, its subtree is closed.\n"
+#pragma endregion
+
+scene_node_t* scene_nodes = NULL;
+
+unsigned int scene_version = 0;
+
+/**
+ * @brief Mark a node dirty and let its ancestors know they have a dirty descendant.
+ */
+static void mark_dirty(const int node)
+{
+    scene_nodes[node].dirty = true;
+
+    for (int i = node; i != SCENE_NO_PARENT && !scene_nodes[i].subtree_dirty; i = scene_nodes[i].parent)
+    {
+        scene_nodes[i].subtree_dirty = true;
+    }
+}
+
+int scene_add_node(const int parent)
+{
+    const int count = array_length(scene_nodes);
+
+    // Appending keeps the array depth-first only if the parent's subtree is the last thing in it.
+    if (parent != SCENE_NO_PARENT &&
+        (parent < 0 || parent >= count || parent + scene_nodes[parent].subtree_size != count))
+    {
+        int _ = fprintf(stderr, SCENE_PARENT_ERR, parent);
+        return -1;
+    }
+
+    const scene_node_t node = {
+        .translation = { 0, 0, 0 },
+        .rotation = { 0, 0, 0 },
+        .local = mat4_identity(),
+        .world = mat4_identity(),
+        .parent = parent,
+        .subtree_size = 1,
+        .dirty = false,
+        .subtree_dirty = false,
+        .world_version = 0
+    };
+    array_push(scene_nodes, node);
+
+    for (int i = parent; i != SCENE_NO_PARENT; i = scene_nodes[i].parent)
+    {
+        scene_nodes[i].subtree_size++;
+    }
+
+    // The new node still needs its world transform.
+    mark_dirty(count);
+
+    return count;
+}
+
+void scene_set_translation(const int node, const vec3_t translation)
+{
+    scene_nodes[node].translation = translation;
+    mark_dirty(node);
+}
+
+void scene_set_rotation(const int node, const vec3_t rotation)
+{
+    scene_nodes[node].rotation = rotation;
+    mark_dirty(node);
+}
+
+void scene_update(void)
+{
+    scene_version++;
+
+    const int count = array_length(scene_nodes);
+
+    for (int i = 0; i < count; )
+    {
+        scene_node_t* node = &scene_nodes[i];
+        const scene_node_t* parent = (node->parent != SCENE_NO_PARENT) ? &scene_nodes[node->parent] : NULL;
+        const bool parent_changed = parent && parent->world_version == scene_version;
+
+        // Nothing in this subtree or above it moved, so none of it needs to be touched.
+        if (!node->subtree_dirty && !parent_changed)
+        {
+            i += node->subtree_size;
+            continue;
+        }
+
+        if (node->dirty)
+        {
+            const mat4_t rotation_x = mat4_make_rotation_x(node->rotation.x);
+            const mat4_t rotation_y = mat4_make_rotation_y(node->rotation.y);
+            const mat4_t rotation_z = mat4_make_rotation_z(node->rotation.z);
+            const mat4_t translation = mat4_make_translation(node->translation);
+
+            node->local = mat4_mul_mat4(&rotation_y, &rotation_x);
+            node->local = mat4_mul_mat4(&rotation_z, &node->local);
+            node->local = mat4_mul_mat4(&translation, &node->local);
+        }
+
+        if (node->dirty || parent_changed)
+        {
+            node->world = parent ? mat4_mul_mat4(&parent->world, &node->local) : node->local;
+            node->world_version = scene_version;
+        }
+
+        node->dirty = false;
+        node->subtree_dirty = false;
+        i++;
+    }
+}
+
+bool scene_node_changed(const int node)
+{
+    return scene_nodes[node].world_version == scene_version;
+}
+
+void free_scene(void)
+{
+    array_free(scene_nodes);
+    scene_nodes = NULL;
+    scene_version = 0;
+}
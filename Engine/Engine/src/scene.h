@@ -0,0 +1,108 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stdbool.h>
+#include "vector.h"
+#include "matrix.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Parent index of a root node.
+ */
+#define SCENE_NO_PARENT (-1)
+#pragma endregion
+
+/**
+ * @brief A node of the scene graph. Nodes are stored in a flat array in depth-first order, so a parent always comes
+ * before its children and a subtree is the node followed by the next subtree_size - 1 nodes.
+ */
+typedef struct
+{
+    /**
+     * @brief Local translation relative to the parent.
+     */
+    vec3_t translation;
+    /**
+     * @brief Local rotation around each axis in radians, applied x first, then y, then z.
+     */
+    vec3_t rotation;
+    /**
+     * @brief Cached local transform built from translation and rotation.
+     */
+    mat4_t local;
+    /**
+     * @brief Cached transform from this node's space to the space of the root's parent.
+     */
+    mat4_t world;
+    /**
+     * @brief Index of the parent node, or SCENE_NO_PARENT.
+     */
+    int parent;
+    /**
+     * @brief Number of nodes in the subtree rooted here, including this node.
+     */
+    int subtree_size;
+    /**
+     * @brief The local transform changed since the last update.
+     */
+    bool dirty;
+    /**
+     * @brief This node or one of its descendants is dirty. Lets the update skip clean subtrees in one step.
+     */
+    bool subtree_dirty;
+    /**
+     * @brief The update in which world was last recomputed.
+     */
+    unsigned int world_version;
+} scene_node_t;
+
+/**
+ * @brief Dynamic array of scene nodes in depth-first order.
+ */
+extern scene_node_t* scene_nodes;
+
+/**
+ * @brief Number of scene updates performed so far.
+ */
+extern unsigned int scene_version;
+
+/**
+ * @brief Append a node to the scene. To keep the array depth-first, the parent's subtree must end at the back of the
+ * array, which is the case when a scene is built parent first and one subtree at a time.
+ * @param parent Index of the parent node, or SCENE_NO_PARENT for a new root.
+ * @return The index of the new node, or -1 if the parent is not valid.
+ */
+int scene_add_node(const int parent);
+
+/**
+ * @brief Set the local translation of a node and mark it dirty.
+ * @param node Index of the node.
+ * @param translation The new translation.
+ */
+void scene_set_translation(const int node, const vec3_t translation);
+
+/**
+ * @brief Set the local rotation of a node and mark it dirty.
+ * @param node Index of the node.
+ * @param rotation The new rotation in radians.
+ */
+void scene_set_rotation(const int node, const vec3_t rotation);
+
+/**
+ * @brief Recompute the world transform of every dirty node and of every node below one, in a single linear pass.
+ */
+void scene_update(void);
+
+/**
+ * @brief Check if the world transform of a node was recomputed by the last update.
+ * @param node Index of the node.
+ * @return True if the node moved in the last update.
+ */
+bool scene_node_changed(const int node);
+
+/**
+ * @brief Release the scene graph.
+ */
+void free_scene(void);
+
+#endif
@@ -0,0 +1,382 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <SDL.h>
+#include "sort.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Error message for when the sort scratch memory cannot be allocated.
+ */
+#define SORT_ALLOCATION_ERR "Error allocating sort buffers.\n"
+#pragma endregion
+
+/**
+ * @brief The slice of the sort handled by one thread.
+ */
+typedef struct
+{
+    /**
+     * @brief Index of the first element of the slice.
+     */
+    int begin;
+    /**
+     * @brief One past the index of the last element of the slice.
+     */
+    int end;
+    /**
+     * @brief Bit position of the digit sorted by the current pass.
+     */
+    int shift;
+    /**
+     * @brief Keys and values read by the current pass.
+     */
+    const uint32_t* keys_in;
+    const int* values_in;
+    /**
+     * @brief Keys and values written by the current pass.
+     */
+    uint32_t* keys_out;
+    int* values_out;
+    /**
+     * @brief Number of keys in the slice per digit, then the first output position of each digit for this slice.
+     */
+    int buckets[RADIX_BUCKETS];
+} radix_job_t;
+
+/**
+ * @brief Ping-pong key buffers, kept between sorts so a frame does not allocate.
+ */
+static uint32_t* sort_keys[2] = { NULL, NULL };
+
+/**
+ * @brief Ping-pong value buffer. The second value buffer is the caller's draw order.
+ */
+static int* sort_values = NULL;
+
+/**
+ * @brief Number of elements the scratch buffers can hold.
+ */
+static int sort_capacity = 0;
+
+/**
+ * @brief Worker threads, started by the first sort that is split and kept until free_sort_buffers(). Worker i runs
+ * slice i of every phase, the calling thread runs slice 0, so entry 0 stays NULL.
+ */
+static SDL_Thread* sort_workers[RADIX_MAX_THREADS] = { NULL };
+
+/**
+ * @brief Posted once per phase to each worker that has a slice in it.
+ */
+static SDL_sem* sort_worker_start[RADIX_MAX_THREADS] = { NULL };
+
+/**
+ * @brief Posted by each worker when it finishes its slice of a phase.
+ */
+static SDL_sem* sort_worker_done = NULL;
+
+/**
+ * @brief Number of slices the workers can take, including the one of the calling thread.
+ */
+static int sort_worker_count = 1;
+
+/**
+ * @brief The phase being run. Written before the start semaphores are posted, which publishes it to the workers.
+ */
+static SDL_ThreadFunction sort_phase_function = NULL;
+static radix_job_t* sort_phase_jobs = NULL;
+
+/**
+ * @brief Set before the workers are woken for the last time, so they return instead of running a phase.
+ */
+static bool sort_workers_quit = false;
+
+/**
+ * @brief Map a float to an unsigned key with the same ordering, then flip it so larger depths sort first.
+ */
+static uint32_t depth_to_key(const float depth)
+{
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+
+    // Negative floats compare backwards, so flip all of their bits. Positive floats just need the sign bit set.
+    const uint32_t ascending = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+    return ~ascending;
+}
+
+/**
+ * @brief Count how many keys of a slice fall in each bucket.
+ */
+static int radix_histogram_job(void* data)
+{
+    radix_job_t* job = (radix_job_t*)data;
+    memset(job->buckets, 0, sizeof(job->buckets));
+
+    for (int i = job->begin; i < job->end; i++)
+    {
+        job->buckets[(job->keys_in[i] >> job->shift) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Move the keys of a slice to their sorted positions. Reading the slice in order keeps the sort stable.
+ */
+static int radix_scatter_job(void* data)
+{
+    radix_job_t* job = (radix_job_t*)data;
+
+    for (int i = job->begin; i < job->end; i++)
+    {
+        const uint32_t key = job->keys_in[i];
+        const int position = job->buckets[(key >> job->shift) & (RADIX_BUCKETS - 1)]++;
+
+        job->keys_out[position] = key;
+        job->values_out[position] = job->values_in[i];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Body of a worker thread: run its slice of every phase until told to quit.
+ */
+static int sort_worker_main(void* data)
+{
+    const int index = (int)(intptr_t)data;
+
+    for (;;)
+    {
+        SDL_SemWait(sort_worker_start[index]);
+
+        if (sort_workers_quit)
+        {
+            return 0;
+        }
+
+        sort_phase_function(&sort_phase_jobs[index]);
+        SDL_SemPost(sort_worker_done);
+    }
+}
+
+/**
+ * @brief Start the workers for up to count slices. Spawning a thread per phase would cost about as much as the work
+ * it splits, so they are started once. Stops at the first worker that cannot be started.
+ */
+static void start_sort_workers(const int count)
+{
+    if (!sort_worker_done)
+    {
+        sort_worker_done = SDL_CreateSemaphore(0);
+
+        if (!sort_worker_done)
+        {
+            return;
+        }
+    }
+
+    while (sort_worker_count < count)
+    {
+        const int index = sort_worker_count;
+        sort_worker_start[index] = SDL_CreateSemaphore(0);
+        sort_workers[index] = sort_worker_start[index] ?
+            SDL_CreateThread(sort_worker_main, "radix_sort", (void*)(intptr_t)index) : NULL;
+
+        if (!sort_workers[index])
+        {
+            SDL_DestroySemaphore(sort_worker_start[index]);
+            sort_worker_start[index] = NULL;
+            return;
+        }
+
+        sort_worker_count++;
+    }
+}
+
+/**
+ * @brief Stop and join the workers.
+ */
+static void stop_sort_workers(void)
+{
+    sort_workers_quit = true;
+
+    for (int i = 1; i < sort_worker_count; i++)
+    {
+        SDL_SemPost(sort_worker_start[i]);
+        SDL_WaitThread(sort_workers[i], NULL);
+        SDL_DestroySemaphore(sort_worker_start[i]);
+        sort_workers[i] = NULL;
+        sort_worker_start[i] = NULL;
+    }
+
+    SDL_DestroySemaphore(sort_worker_done);
+    sort_worker_done = NULL;
+    sort_worker_count = 1;
+    sort_workers_quit = false;
+}
+
+/**
+ * @brief Run a job on every slice, slice 0 on the calling thread and the others on the workers.
+ */
+static void run_radix_jobs(SDL_ThreadFunction function, radix_job_t* jobs, const int n_jobs)
+{
+    sort_phase_function = function;
+    sort_phase_jobs = jobs;
+
+    for (int i = 1; i < n_jobs; i++)
+    {
+        SDL_SemPost(sort_worker_start[i]);
+    }
+
+    function(&jobs[0]);
+
+    for (int i = 1; i < n_jobs; i++)
+    {
+        SDL_SemWait(sort_worker_done);
+    }
+}
+
+/**
+ * @brief Release the scratch buffers.
+ */
+static void free_sort_memory(void)
+{
+    free(sort_keys[0]);
+    free(sort_keys[1]);
+    free(sort_values);
+    sort_keys[0] = NULL;
+    sort_keys[1] = NULL;
+    sort_values = NULL;
+    sort_capacity = 0;
+}
+
+/**
+ * @brief Make sure the scratch buffers can hold count elements.
+ */
+static bool reserve_sort_buffers(const int count)
+{
+    if (count <= sort_capacity)
+    {
+        return true;
+    }
+
+    free_sort_memory();
+
+    sort_keys[0] = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    sort_keys[1] = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    sort_values = (int*)malloc(sizeof(int) * count);
+
+    if (!sort_keys[0] || !sort_keys[1] || !sort_values)
+    {
+        int _ = fprintf(stderr, SORT_ALLOCATION_ERR);
+        free_sort_memory();
+        return false;
+    }
+
+    sort_capacity = count;
+    return true;
+}
+
+void sort_triangles_back_to_front(const triangle_t* triangles, const int count, int* draw_order)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    if (!reserve_sort_buffers(count))
+    {
+        // Fall back to the order the triangles were emitted in.
+        for (int i = 0; i < count; i++)
+        {
+            draw_order[i] = i;
+        }
+
+        return;
+    }
+
+    uint32_t* keys[2] = { sort_keys[0], sort_keys[1] };
+    int* values[2] = { draw_order, sort_values };
+
+    for (int i = 0; i < count; i++)
+    {
+        keys[0][i] = depth_to_key(triangles[i].depth);
+        values[0][i] = i;
+    }
+
+    // Split large sorts into contiguous slices, one per thread.
+    int n_jobs = 1;
+
+    if (count >= RADIX_PARALLEL_THRESHOLD)
+    {
+        n_jobs = SDL_GetCPUCount();
+        n_jobs = (n_jobs < 1) ? 1 : (n_jobs > RADIX_MAX_THREADS) ? RADIX_MAX_THREADS : n_jobs;
+        start_sort_workers(n_jobs);
+        n_jobs = (n_jobs > sort_worker_count) ? sort_worker_count : n_jobs;
+    }
+
+    radix_job_t jobs[RADIX_MAX_THREADS];
+    int source = 0;
+
+    for (int pass = 0; pass < RADIX_PASSES; pass++)
+    {
+        const int target = 1 - source;
+
+        for (int j = 0; j < n_jobs; j++)
+        {
+            jobs[j].begin = (int)(((long long)count * j) / n_jobs);
+            jobs[j].end = (int)(((long long)count * (j + 1)) / n_jobs);
+            jobs[j].shift = pass * RADIX_BITS;
+            jobs[j].keys_in = keys[source];
+            jobs[j].values_in = values[source];
+            jobs[j].keys_out = keys[target];
+            jobs[j].values_out = values[target];
+        }
+
+        run_radix_jobs(radix_histogram_job, jobs, n_jobs);
+
+        // Turn the counts into output positions. Every slice of a bucket goes after the same bucket of the slices
+        // before it, which keeps the sort stable across threads.
+        int position = 0;
+        int largest_bucket = 0;
+
+        for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++)
+        {
+            int bucket_size = 0;
+
+            for (int j = 0; j < n_jobs; j++)
+            {
+                const int slice_count = jobs[j].buckets[bucket];
+                jobs[j].buckets[bucket] = position;
+                position += slice_count;
+                bucket_size += slice_count;
+            }
+
+            largest_bucket = (bucket_size > largest_bucket) ? bucket_size : largest_bucket;
+        }
+
+        // Every key has the same digit, the pass would not move anything.
+        if (largest_bucket == count)
+        {
+            continue;
+        }
+
+        run_radix_jobs(radix_scatter_job, jobs, n_jobs);
+        source = target;
+    }
+
+    // Odd number of passes actually ran, the result is in the scratch buffer.
+    if (values[source] != draw_order)
+    {
+        memcpy(draw_order, values[source], sizeof(int) * count);
+    }
+}
+
+void free_sort_buffers(void)
+{
+    stop_sort_workers();
+    free_sort_memory();
+}
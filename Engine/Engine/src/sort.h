@@ -0,0 +1,50 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "triangle.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Number of bits of the key sorted by each radix pass.
+ */
+#define RADIX_BITS 8
+
+/**
+ * @brief Number of buckets in each radix pass.
+ */
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+/**
+ * @brief Number of passes needed to sort a 32-bit key.
+ */
+#define RADIX_PASSES (32 / RADIX_BITS)
+
+/**
+ * @brief Smallest number of triangles for which the sort is split across threads. Below this, waking the threads
+ * costs more than it saves.
+ */
+#define RADIX_PARALLEL_THRESHOLD (1 << 18)
+
+/**
+ * @brief Maximum number of threads used by the sort.
+ */
+#define RADIX_MAX_THREADS 16
+#pragma endregion
+
+/**
+ * @brief Compute the draw order that paints triangles back to front, farthest first.
+ *
+ * This is a stable LSD radix sort on the depth of each triangle, so triangles at the same depth keep the order they
+ * were emitted in. Only the indices move, the triangles are left where they are.
+ * @param triangles The triangles to order.
+ * @param count The number of triangles.
+ * @param draw_order Receives count indices into triangles, in the order they should be drawn.
+ */
+void sort_triangles_back_to_front(const triangle_t* triangles, const int count, int* draw_order);
+
+/**
+ * @brief Release the scratch memory and stop the worker threads kept between sorts.
+ */
+void free_sort_buffers(void);
+
+#endif
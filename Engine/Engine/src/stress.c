@@ -0,0 +1,200 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/array.h"
+#include "mesh.h"
+#include "stress.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Half the thickness of the slab the triangles are spread through, in model units.
+ */
+#define STRESS_SLAB_DEPTH 1.0f
+
+/**
+ * @brief Closest an off-screen triangle gets to the middle of the screen, in model units. About 2600 pixels from the
+ * middle, past the edge of a 3840x2160 screen.
+ */
+#define STRESS_OFFSCREEN_MIN_DISTANCE 20.0f
+
+/**
+ * @brief Farthest an off-screen triangle gets from the middle of the screen, in model units.
+ */
+#define STRESS_OFFSCREEN_MAX_DISTANCE 40.0f
+
+/**
+ * @brief Model units covered by one repeat of the texture.
+ */
+#define STRESS_TEXTURE_REPEAT 1.0f
+
+/**
+ * @brief Pi, which C does not define.
+ */
+#define STRESS_PI 3.14159265f
+#pragma endregion
+
+/**
+ * @brief State of the pseudo random generator.
+ */
+static uint32_t stress_random_state = STRESS_DEFAULT_SEED;
+
+/**
+ * @brief Uniform random number in [0, 1). A linear congruential generator, identical on every platform unlike rand().
+ */
+static float stress_random(void)
+{
+    stress_random_state = stress_random_state * 1664525u + 1013904223u;
+    return (float)(stress_random_state >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Uniform random number in [low, high).
+ */
+static float stress_random_range(const float low, const float high)
+{
+    return low + ((high - low) * stress_random());
+}
+
+bool parse_stress_params(const int argc, char* argv[], stress_params_t* params)
+{
+    params->enabled = false;
+    params->seed = STRESS_DEFAULT_SEED;
+    params->triangles = STRESS_DEFAULT_TRIANGLES;
+    params->min_size = STRESS_DEFAULT_MIN_SIZE;
+    params->max_size = STRESS_DEFAULT_MAX_SIZE;
+    params->size_exponent = STRESS_DEFAULT_SIZE_EXPONENT;
+    params->overdraw = STRESS_DEFAULT_OVERDRAW;
+    params->offscreen_fraction = STRESS_DEFAULT_OFFSCREEN;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--stress") == 0)
+        {
+            params->enabled = true;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            params->seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--triangles") == 0 && i + 1 < argc)
+        {
+            params->triangles = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 2 < argc)
+        {
+            params->min_size = strtof(argv[++i], NULL);
+            params->max_size = strtof(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "--size-exponent") == 0 && i + 1 < argc)
+        {
+            params->size_exponent = strtof(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "--overdraw") == 0 && i + 1 < argc)
+        {
+            params->overdraw = strtof(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "--offscreen") == 0 && i + 1 < argc)
+        {
+            params->offscreen_fraction = strtof(argv[++i], NULL);
+        }
+    }
+
+    // Keep the generator away from values it cannot use.
+    params->triangles = (params->triangles > 0) ? params->triangles : 0;
+    params->min_size = (params->min_size > 0.0f) ? params->min_size : STRESS_DEFAULT_MIN_SIZE;
+    params->max_size = (params->max_size >= params->min_size) ? params->max_size : params->min_size;
+    params->size_exponent = (params->size_exponent > 0.0f) ? params->size_exponent : STRESS_DEFAULT_SIZE_EXPONENT;
+    params->overdraw = (params->overdraw > 0.0f) ? params->overdraw : STRESS_DEFAULT_OVERDRAW;
+    params->offscreen_fraction = fminf(fmaxf(params->offscreen_fraction, 0.0f), 1.0f);
+
+    return params->enabled;
+}
+
+void load_stress_mesh_data(const stress_params_t* params)
+{
+    mesh_t scene = { 0 };
+    stress_random_state = params->seed;
+
+    // Spread the on-screen triangles over a square whose area is their expected total area divided by the overdraw.
+    // For s = a + (b - a) * r^k with a uniform r, E[s^2] = a^2 + 2a(b - a) / (k + 1) + (b - a)^2 / (2k + 1).
+    const float a = params->min_size;
+    const float range = params->max_size - params->min_size;
+    const float k = params->size_exponent;
+    const float mean_squared_size = (a * a) + (2.0f * a * range / (k + 1.0f)) + (range * range / ((2.0f * k) + 1.0f));
+    const int offscreen_triangles = (int)lrintf(params->offscreen_fraction * (float)params->triangles);
+    const int onscreen_triangles = params->triangles - offscreen_triangles;
+    const float total_area = (float)onscreen_triangles * (sqrtf(3.0f) / 4.0f) * mean_squared_size;
+    const float half_extent = 0.5f * sqrtf(total_area / params->overdraw);
+
+    for (int i = 0; i < params->triangles; i++)
+    {
+        const float size = a + (range * powf(stress_random(), k));
+        const float angle = stress_random_range(0.0f, 2.0f * STRESS_PI);
+        vec3_t center = { 0.0f, 0.0f, stress_random_range(-STRESS_SLAB_DEPTH, STRESS_SLAB_DEPTH) };
+
+        // Off-screen triangles are spread evenly among the on-screen ones, so any prefix of the mesh is
+        // representative.
+        const bool offscreen = ((i + 1) * offscreen_triangles) / params->triangles !=
+            (i * offscreen_triangles) / params->triangles;
+
+        if (offscreen)
+        {
+            const float direction = stress_random_range(0.0f, 2.0f * STRESS_PI);
+            const float distance = stress_random_range(STRESS_OFFSCREEN_MIN_DISTANCE, STRESS_OFFSCREEN_MAX_DISTANCE);
+            center.x = distance * cosf(direction);
+            center.y = distance * sinf(direction);
+        }
+        else
+        {
+            center.x = stress_random_range(-half_extent, half_extent);
+            center.y = stress_random_range(-half_extent, half_extent);
+        }
+
+        // Equilateral triangle with the requested edge, at a random orientation.
+        const float radius = size / sqrtf(3.0f);
+        vec3_t corners[3];
+        tex2_t texcoords[3];
+
+        for (int j = 0; j < 3; j++)
+        {
+            const float corner_angle = angle + ((float)j * 2.0f * STRESS_PI / 3.0f);
+            corners[j].x = center.x + (radius * cosf(corner_angle));
+            corners[j].y = center.y + (radius * sinf(corner_angle));
+            corners[j].z = center.z;
+            texcoords[j].u = corners[j].x / STRESS_TEXTURE_REPEAT;
+            texcoords[j].v = corners[j].y / STRESS_TEXTURE_REPEAT;
+        }
+
+        const unsigned int first_vertex = (unsigned int)array_length(scene.vertices) + 1;
+        face_t face = {
+            .a = first_vertex,
+            .b = first_vertex + 1,
+            .c = first_vertex + 2,
+            .a_uv = texcoords[0],
+            .b_uv = texcoords[1],
+            .c_uv = texcoords[2]
+        };
+
+        // Faces are wound clockwise as seen from the camera, which looks down +z.
+        const vec3_t normal = vec3_cross(vec3_sub(corners[1], corners[0]), vec3_sub(corners[2], corners[0]));
+
+        if (normal.z > 0.0f)
+        {
+            face.b = first_vertex + 2;
+            face.c = first_vertex + 1;
+            face.b_uv = texcoords[2];
+            face.c_uv = texcoords[1];
+        }
+
+        for (int j = 0; j < 3; j++)
+        {
+            array_push(scene.vertices, corners[j]);
+        }
+
+        array_push(scene.faces, face);
+    }
+
+    compute_mesh_normals(&scene);
+    quantize_mesh(&mesh, &scene);
+    free_mesh(&scene);
+}
@@ -0,0 +1,102 @@
+#ifndef STRESS_H
+#define STRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#pragma region Preprocessor directives
+/**
+ * @brief Default seed of the stress scene.
+ */
+#define STRESS_DEFAULT_SEED 1
+
+/**
+ * @brief Default number of triangles in the stress scene.
+ */
+#define STRESS_DEFAULT_TRIANGLES 10000
+
+/**
+ * @brief Default smallest triangle edge, in model units. The mesh sits 5 units from the camera, where one unit is
+ * about 130 pixels.
+ */
+#define STRESS_DEFAULT_MIN_SIZE 0.02f
+
+/**
+ * @brief Default largest triangle edge, in model units.
+ */
+#define STRESS_DEFAULT_MAX_SIZE 0.5f
+
+/**
+ * @brief Default shape of the size distribution. Sizes are min + (max - min) * r^exponent for a uniform r, so 1 is
+ * uniform and larger values favour small triangles.
+ */
+#define STRESS_DEFAULT_SIZE_EXPONENT 2.0f
+
+/**
+ * @brief Default average number of triangles covering a point of the area the on-screen triangles are spread over.
+ */
+#define STRESS_DEFAULT_OVERDRAW 4.0f
+
+/**
+ * @brief Default fraction of the triangles placed well outside the screen.
+ */
+#define STRESS_DEFAULT_OFFSCREEN 0.1f
+#pragma endregion
+
+/**
+ * @brief Parameters of a procedurally generated stress scene. The same parameters always generate the same mesh.
+ */
+typedef struct
+{
+    /**
+     * @brief Use the stress scene instead of the cube. Set by --stress.
+     */
+    bool enabled;
+    /**
+     * @brief Seed of the generator. Set by --seed <n>.
+     */
+    uint32_t seed;
+    /**
+     * @brief Number of triangles. Set by --triangles <n>.
+     */
+    int triangles;
+    /**
+     * @brief Smallest triangle edge in model units. Set by --size <min> <max>.
+     */
+    float min_size;
+    /**
+     * @brief Largest triangle edge in model units. Set by --size <min> <max>.
+     */
+    float max_size;
+    /**
+     * @brief Shape of the size distribution, see STRESS_DEFAULT_SIZE_EXPONENT. Set by --size-exponent <x>.
+     */
+    float size_exponent;
+    /**
+     * @brief Average number of on-screen triangles covering each point of the area they are spread over. Set by
+     * --overdraw <x>.
+     */
+    float overdraw;
+    /**
+     * @brief Fraction of the triangles placed outside the screen, between 0 and 1. Set by --offscreen <x>.
+     */
+    float offscreen_fraction;
+} stress_params_t;
+
+/**
+ * @brief Parse the stress scene parameters out of the command line.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @param params Receives the parameters.
+ * @return True if a stress scene was requested.
+ */
+bool parse_stress_params(const int argc, char* argv[], stress_params_t* params);
+
+/**
+ * @brief Generate a stress scene into the global mesh. Every triangle faces the camera, so none are culled, and
+ * sits in a thin slab around the origin of the mesh.
+ * @param params The parameters of the scene.
+ */
+void load_stress_mesh_data(const stress_params_t* params);
+
+#endif
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "texture.h"
+
+#pragma region Preprocessor directives
+/**
+ * @brief Error message for when a texture has dimensions that are not powers of two.
+ */
+#define TEXTURE_SIZE_ERR "Texture dimensions must be powers of two, got %dx%d.\n"
+
+/**
+ * @brief Error message for when the texture storage cannot be allocated.
+ */
+#define TEXTURE_ALLOCATION_ERR "Error allocating texture storage.\n"
+#pragma endregion
+
+texture_t mesh_texture = { 0 };
+
+/**
+ * @brief Check if a value is a positive power of two.
+ */
+static bool is_power_of_two(const int value)
+{
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+/**
+ * @brief Number of tiles needed to cover a number of texels. Levels smaller than a tile still take a whole tile.
+ */
+static int tiles_for(const int texels)
+{
+    return (texels + TEXTURE_TILE_SIZE - 1) >> TEXTURE_TILE_SHIFT;
+}
+
+/**
+ * @brief Average four ARGB colors channel by channel.
+ */
+static uint32_t average_argb(const uint32_t c0, const uint32_t c1, const uint32_t c2, const uint32_t c3)
+{
+    uint32_t result = 0;
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        const uint32_t sum =
+            ((c0 >> shift) & 0xFF) +
+            ((c1 >> shift) & 0xFF) +
+            ((c2 >> shift) & 0xFF) +
+            ((c3 >> shift) & 0xFF);
+
+        result |= ((sum + 2) >> 2) << shift;
+    }
+
+    return result;
+}
+
+bool texture_create(texture_t* texture, const uint32_t* pixels, const int width, const int height)
+{
+    if (!is_power_of_two(width) || !is_power_of_two(height))
+    {
+        int _ = fprintf(stderr, TEXTURE_SIZE_ERR, width, height);
+        return false;
+    }
+
+    // Lay out every level back to back in a single allocation.
+    size_t offsets[TEXTURE_MAX_MIP_LEVELS];
+    size_t total_texels = 0;
+    int levels = 0;
+
+    for (int w = width, h = height; levels < TEXTURE_MAX_MIP_LEVELS; levels++)
+    {
+        texture_level_t* level = &texture->levels[levels];
+        level->width = w;
+        level->height = h;
+        level->tiles_per_row = tiles_for(w);
+        offsets[levels] = total_texels;
+
+        total_texels += (size_t)level->tiles_per_row * tiles_for(h) * TEXTURE_TILE_TEXELS;
+
+        if (w == 1 && h == 1)
+        {
+            levels++;
+            break;
+        }
+
+        w = (w > 1) ? w / 2 : 1;
+        h = (h > 1) ? h / 2 : 1;
+    }
+
+    texture->storage = (uint32_t*)calloc(total_texels, sizeof(uint32_t));
+
+    if (!texture->storage)
+    {
+        // Leave no levels behind for the fill kernels to sample.
+        texture->mip_levels = 0;
+        int _ = fprintf(stderr, TEXTURE_ALLOCATION_ERR);
+        return false;
+    }
+
+    texture->mip_levels = levels;
+
+    for (int i = 0; i < levels; i++)
+    {
+        texture->levels[i].texels = texture->storage + offsets[i];
+    }
+
+    // Swizzle the source image into level 0.
+    const texture_level_t* base = &texture->levels[0];
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            base->texels[texture_texel_offset(base, x, y)] = pixels[(width * y) + x];
+        }
+    }
+
+    // Build every other level with a 2x2 box filter over the previous one.
+    for (int i = 1; i < levels; i++)
+    {
+        const texture_level_t* source = &texture->levels[i - 1];
+        const texture_level_t* target = &texture->levels[i];
+
+        for (int y = 0; y < target->height; y++)
+        {
+            // A dimension that already reached 1 texel is not halved again.
+            const int y0 = (source->height > 1) ? y * 2 : y;
+            const int y1 = (source->height > 1) ? y0 + 1 : y0;
+
+            for (int x = 0; x < target->width; x++)
+            {
+                const int x0 = (source->width > 1) ? x * 2 : x;
+                const int x1 = (source->width > 1) ? x0 + 1 : x0;
+
+                target->texels[texture_texel_offset(target, x, y)] = average_argb(
+                    source->texels[texture_texel_offset(source, x0, y0)],
+                    source->texels[texture_texel_offset(source, x1, y0)],
+                    source->texels[texture_texel_offset(source, x0, y1)],
+                    source->texels[texture_texel_offset(source, x1, y1)]
+                );
+            }
+        }
+    }
+
+    return true;
+}
+
+bool texture_create_checkerboard(texture_t* texture, const int size, const int checks, const uint32_t color_a,
+    const uint32_t color_b)
+{
+    if (!is_power_of_two(size) || checks <= 0)
+    {
+        int _ = fprintf(stderr, TEXTURE_SIZE_ERR, size, size);
+        return false;
+    }
+
+    uint32_t* pixels = (uint32_t*)malloc(sizeof(uint32_t) * size * size);
+
+    if (!pixels)
+    {
+        int _ = fprintf(stderr, TEXTURE_ALLOCATION_ERR);
+        return false;
+    }
+
+    const int check_size = (size / checks > 0) ? size / checks : 1;
+
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            pixels[(size * y) + x] = (((x / check_size) + (y / check_size)) % 2 == 0) ? color_a : color_b;
+        }
+    }
+
+    const bool created = texture_create(texture, pixels, size, size);
+    free(pixels);
+
+    return created;
+}
+
+int texture_select_mip_level(const texture_t* texture, const float uv_area, const float screen_area)
+{
+    if (texture->mip_levels <= 1 || screen_area == 0.0f)
+    {
+        return 0;
+    }
+
+    // Texels covered per pixel. Every level has a quarter of the texels of the previous one, so the level is half
+    // the log2 of the ratio.
+    const float texel_area = fabsf(uv_area) * (float)texture->levels[0].width * (float)texture->levels[0].height;
+    const float texels_per_pixel = texel_area / fabsf(screen_area);
+
+    if (texels_per_pixel <= 1.0f)
+    {
+        return 0;
+    }
+
+    const int level = (int)(0.5f * log2f(texels_per_pixel));
+
+    return (level < texture->mip_levels) ? level : texture->mip_levels - 1;
+}
+
+void texture_free(texture_t* texture)
+{
+    free(texture->storage);
+    texture->storage = NULL;
+    texture->mip_levels = 0;
+}
@@ -0,0 +1,163 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#pragma region Preprocessor directives
+/**
+ * @brief Width and height in texels of a single texture tile. A 4x4 tile of 32-bit texels is 64 bytes, which is
+ * exactly one cache line, so neighbouring texels in both u and v usually share a line.
+ */
+#define TEXTURE_TILE_SIZE 4
+
+/**
+ * @brief Log2 of TEXTURE_TILE_SIZE, used to turn texel coordinates into tile coordinates with shifts.
+ */
+#define TEXTURE_TILE_SHIFT 2
+
+/**
+ * @brief Number of texels stored in a single tile.
+ */
+#define TEXTURE_TILE_TEXELS (TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE)
+
+/**
+ * @brief Maximum number of mip levels in a mip chain. Enough for a 32768x32768 texture.
+ */
+#define TEXTURE_MAX_MIP_LEVELS 16
+#pragma endregion
+
+/**
+ * @brief A 2D texture coordinate.
+ */
+typedef struct
+{
+    /**
+     * @brief The horizontal texture coordinate, 0 at the left edge and 1 at the right edge.
+     */
+    float u;
+    /**
+     * @brief The vertical texture coordinate, 0 at the top edge and 1 at the bottom edge.
+     */
+    float v;
+} tex2_t;
+
+/**
+ * @brief A single level of a mip chain stored in a tiled layout.
+ */
+typedef struct
+{
+    /**
+     * @brief Width of the level in texels. Always a power of two.
+     */
+    int width;
+    /**
+     * @brief Height of the level in texels. Always a power of two.
+     */
+    int height;
+    /**
+     * @brief Number of tiles in a row of this level.
+     */
+    int tiles_per_row;
+    /**
+     * @brief Pointer to the first tile of this level inside the texture storage.
+     */
+    uint32_t* texels;
+} texture_level_t;
+
+/**
+ * @brief A texture with a precomputed mip chain. Every level is stored as rows of 4x4 tiles instead of rows of
+ * texels.
+ */
+typedef struct
+{
+    /**
+     * @brief The number of valid entries in levels.
+     */
+    int mip_levels;
+    /**
+     * @brief The mip chain, level 0 being the full resolution image.
+     */
+    texture_level_t levels[TEXTURE_MAX_MIP_LEVELS];
+    /**
+     * @brief The single allocation holding the texels of every level.
+     */
+    uint32_t* storage;
+} texture_t;
+
+/**
+ * @brief The texture applied to the loaded mesh.
+ */
+extern texture_t mesh_texture;
+
+/**
+ * @brief Create a texture and its full mip chain from a row-major image.
+ * @param texture The texture to initialize.
+ * @param pixels Row-major ARGB pixels, width * height entries.
+ * @param width Width of the image. Must be a power of two.
+ * @param height Height of the image. Must be a power of two.
+ * @return True if the texture was created, false otherwise.
+ */
+bool texture_create(texture_t* texture, const uint32_t* pixels, const int width, const int height);
+
+/**
+ * @brief Create a square checkerboard texture.
+ * @param texture The texture to initialize.
+ * @param size Width and height of the texture. Must be a power of two.
+ * @param checks Number of checks along each side.
+ * @param color_a The ARGB color of the even checks.
+ * @param color_b The ARGB color of the odd checks.
+ * @return True if the texture was created, false otherwise.
+ */
+bool texture_create_checkerboard(texture_t* texture, const int size, const int checks, const uint32_t color_a,
+    const uint32_t color_b);
+
+/**
+ * @brief Pick the mip level whose texel density best matches a triangle's footprint on screen.
+ * @param texture The texture being sampled.
+ * @param uv_area Twice the area of the triangle in texture coordinate space.
+ * @param screen_area Twice the area of the triangle in pixels.
+ * @return The index of the mip level to sample.
+ */
+int texture_select_mip_level(const texture_t* texture, const float uv_area, const float screen_area);
+
+/**
+ * @brief Release the memory held by a texture.
+ * @param texture The texture to free.
+ */
+void texture_free(texture_t* texture);
+
+/**
+ * @brief Find the offset of a texel inside a tiled level.
+ * @param level The level the texel belongs to.
+ * @param x The column of the texel.
+ * @param y The row of the texel.
+ * @return The offset of the texel from level->texels.
+ */
+static inline int texture_texel_offset(const texture_level_t* level, const int x, const int y)
+{
+    const int tile = ((y >> TEXTURE_TILE_SHIFT) * level->tiles_per_row) + (x >> TEXTURE_TILE_SHIFT);
+
+    return (tile * TEXTURE_TILE_TEXELS)
+        + ((y & (TEXTURE_TILE_SIZE - 1)) * TEXTURE_TILE_SIZE)
+        + (x & (TEXTURE_TILE_SIZE - 1));
+}
+
+/**
+ * @brief Sample a level with nearest filtering. Coordinates outside of [0, 1) wrap around.
+ * @param level The level to sample.
+ * @param u The horizontal texture coordinate.
+ * @param v The vertical texture coordinate.
+ * @return The ARGB color of the texel.
+ */
+static inline uint32_t texture_sample(const texture_level_t* level, const float u, const float v)
+{
+    // Levels are powers of two, so wrapping is a mask.
+    const int x = (int)floorf(u * (float)level->width) & (level->width - 1);
+    const int y = (int)floorf(v * (float)level->height) & (level->height - 1);
+
+    return level->texels[texture_texel_offset(level, x, y)];
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "tiles.h"
+
+/**
+ * @brief One combination of TILE_DRAWN bits per tile, row by row.
+ */
+static uint8_t* tile_states = NULL;
+
+/**
+ * @brief Number of tiles per row.
+ */
+static int tile_columns = 0;
+
+/**
+ * @brief Number of tile rows.
+ */
+static int tile_rows = 0;
+
+/**
+ * @brief Width of the screen the grid covers, used to clip the runs.
+ */
+static int screen_width = 0;
+
+/**
+ * @brief Height of the screen the grid covers, used to clip the runs.
+ */
+static int screen_height = 0;
+
+bool tiles_resize(const int width, const int height)
+{
+    free_tiles();
+
+    const int columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    if (columns <= 0 || rows <= 0)
+    {
+        return false;
+    }
+
+    tile_states = (uint8_t*)calloc((size_t)columns * rows, sizeof(uint8_t));
+
+    if (!tile_states)
+    {
+        return false;
+    }
+
+    tile_columns = columns;
+    tile_rows = rows;
+    screen_width = width;
+    screen_height = height;
+    tiles_mark_all();
+
+    return true;
+}
+
+void tiles_mark_rect(const int min_x, const int min_y, const int max_x, const int max_y)
+{
+    if (!tile_states || max_x < 0 || max_y < 0 || min_x >= screen_width || min_y >= screen_height ||
+        min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+
+    const int first_column = (min_x < 0) ? 0 : min_x / TILE_SIZE;
+    const int first_row = (min_y < 0) ? 0 : min_y / TILE_SIZE;
+    const int last_column = (max_x >= screen_width) ? tile_columns - 1 : max_x / TILE_SIZE;
+    const int last_row = (max_y >= screen_height) ? tile_rows - 1 : max_y / TILE_SIZE;
+
+    for (int row = first_row; row <= last_row; row++)
+    {
+        uint8_t* states = &tile_states[row * tile_columns];
+
+        for (int column = first_column; column <= last_column; column++)
+        {
+            states[column] |= TILE_DRAWN;
+        }
+    }
+}
+
+void tiles_mark_all(void)
+{
+    for (int i = 0; i < tile_columns * tile_rows; i++)
+    {
+        tile_states[i] |= TILE_DRAWN;
+    }
+}
+
+void tiles_for_each_run(const int state_mask, const tile_run_callback_t callback, void* data)
+{
+    for (int row = 0; row < tile_rows; row++)
+    {
+        const uint8_t* states = &tile_states[row * tile_columns];
+        int column = 0;
+
+        while (column < tile_columns)
+        {
+            if (!(states[column] & state_mask))
+            {
+                column++;
+                continue;
+            }
+
+            const int first_column = column;
+
+            while (column < tile_columns && (states[column] & state_mask))
+            {
+                column++;
+            }
+
+            tile_run_t run = {
+                .x = first_column * TILE_SIZE,
+                .y = row * TILE_SIZE,
+                .width = (column - first_column) * TILE_SIZE,
+                .height = TILE_SIZE
+            };
+
+            // The last column and row may hang off the screen.
+            run.width = (run.x + run.width > screen_width) ? screen_width - run.x : run.width;
+            run.height = (run.y + run.height > screen_height) ? screen_height - run.y : run.height;
+
+            callback(&run, data);
+        }
+    }
+}
+
+int tiles_count_marked(const int state_mask)
+{
+    int marked = 0;
+
+    for (int i = 0; i < tile_columns * tile_rows; i++)
+    {
+        marked += (tile_states[i] & state_mask) ? 1 : 0;
+    }
+
+    return marked;
+}
+
+int tiles_count(void)
+{
+    return tile_columns * tile_rows;
+}
+
+void tiles_next_frame(void)
+{
+    for (int i = 0; i < tile_columns * tile_rows; i++)
+    {
+        tile_states[i] = (tile_states[i] & TILE_DRAWN) ? TILE_DRAWN_PREVIOUS : 0;
+    }
+}
+
+void free_tiles(void)
+{
+    free(tile_states);
+    tile_states = NULL;
+    tile_columns = 0;
+    tile_rows = 0;
+    screen_width = 0;
+    screen_height = 0;
+}
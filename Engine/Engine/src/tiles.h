@@ -0,0 +1,104 @@
+#ifndef TILES_H
+#define TILES_H
+
+#include <stdbool.h>
+
+#pragma region Preprocessor directives
+/**
+ * @brief Width and height of a tile in pixels.
+ */
+#define TILE_SIZE 32
+
+/**
+ * @brief Tile state bit: something was drawn into the tile this frame.
+ */
+#define TILE_DRAWN 1
+
+/**
+ * @brief Tile state bit: something was drawn into the tile last frame.
+ */
+#define TILE_DRAWN_PREVIOUS 2
+#pragma endregion
+
+/**
+ * @brief A horizontal run of tiles, in pixels, clipped to the screen.
+ */
+typedef struct
+{
+    /**
+     * @brief The leftmost pixel column of the run.
+     */
+    int x;
+    /**
+     * @brief The top pixel row of the run.
+     */
+    int y;
+    /**
+     * @brief The width of the run in pixels.
+     */
+    int width;
+    /**
+     * @brief The height of the run in pixels.
+     */
+    int height;
+} tile_run_t;
+
+/**
+ * @brief Called once per run of tiles, with the data passed to tiles_for_each_run().
+ */
+typedef void (*tile_run_callback_t)(const tile_run_t* run, void* data);
+
+/**
+ * @brief Size the tile grid for a color buffer. Every tile starts out drawn, so the first clear and upload cover the
+ * whole screen.
+ * @param width The width of the color buffer in pixels.
+ * @param height The height of the color buffer in pixels.
+ * @return False if the tile grid could not be allocated.
+ */
+bool tiles_resize(const int width, const int height);
+
+/**
+ * @brief Mark the tiles overlapping a rectangle as drawn this frame. The rectangle is clipped to the screen.
+ * @param min_x The leftmost pixel column.
+ * @param min_y The topmost pixel row.
+ * @param max_x The rightmost pixel column.
+ * @param max_y The bottom pixel row.
+ */
+void tiles_mark_rect(const int min_x, const int min_y, const int max_x, const int max_y);
+
+/**
+ * @brief Mark every tile as drawn this frame, for when something drew without marking tiles.
+ */
+void tiles_mark_all(void);
+
+/**
+ * @brief Visit the runs of consecutive tiles in each tile row whose state has one of the given bits set.
+ * @param state_mask A combination of TILE_DRAWN and TILE_DRAWN_PREVIOUS.
+ * @param callback Called for each run.
+ * @param data Passed on to the callback.
+ */
+void tiles_for_each_run(const int state_mask, const tile_run_callback_t callback, void* data);
+
+/**
+ * @brief Count the tiles whose state has one of the given bits set.
+ * @param state_mask A combination of TILE_DRAWN and TILE_DRAWN_PREVIOUS.
+ * @return The number of tiles.
+ */
+int tiles_count_marked(const int state_mask);
+
+/**
+ * @brief The number of tiles in the grid.
+ */
+int tiles_count(void);
+
+/**
+ * @brief Move on to the next frame: what was drawn this frame becomes what was drawn last frame.
+ */
+void tiles_next_frame(void);
+
+/**
+ * @brief Release the tile grid.
+ */
+void free_tiles(void);
+
+#endif
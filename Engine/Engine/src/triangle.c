@@ -1,3 +1,37 @@
+#include <math.h>
 #include "triangle.h"
 
-// TODO: Create implementation for TRIANGLE_H functions.
\ No newline at end of file
+/**
+ * @brief Pack one texture coordinate with the given number of fractional bits, clamped to the packed range.
+ */
+static int16_t pack_texcoord(const float coordinate, const int bits)
+{
+    const long packed = lrintf(ldexpf(coordinate, bits));
+
+    return (int16_t)((packed < INT16_MIN) ? INT16_MIN : ((packed > INT16_MAX) ? INT16_MAX : packed));
+}
+
+int pack_face_texcoords(const tex2_t texcoords[N_POINTS_TRIANGLE], tex2_packed_t packed[N_POINTS_TRIANGLE])
+{
+    const float repeat_u = floorf(fminf(texcoords[0].u, fminf(texcoords[1].u, texcoords[2].u)));
+    const float repeat_v = floorf(fminf(texcoords[0].v, fminf(texcoords[1].v, texcoords[2].v)));
+
+    // After rebasing every coordinate is at least 0, so only the largest one can overflow.
+    const float span_u = fmaxf(texcoords[0].u, fmaxf(texcoords[1].u, texcoords[2].u)) - repeat_u;
+    const float span_v = fmaxf(texcoords[0].v, fmaxf(texcoords[1].v, texcoords[2].v)) - repeat_v;
+    const float span = fmaxf(span_u, span_v);
+    int bits = TEXCOORD_FRACTION_BITS;
+
+    while (bits > 0 && ldexpf(span, bits) > (float)INT16_MAX)
+    {
+        bits--;
+    }
+
+    for (int i = 0; i < N_POINTS_TRIANGLE; i++)
+    {
+        packed[i].u = pack_texcoord(texcoords[i].u - repeat_u, bits);
+        packed[i].v = pack_texcoord(texcoords[i].v - repeat_v, bits);
+    }
+
+    return bits;
+}
@@ -33,3 +33,70 @@ vec3_t vec3_rotate_z(const vec3_t original_vector, const float angle)
 
     return rotated_vector;
 }
+
+vec3_t vec3_sub(const vec3_t a, const vec3_t b)
+{
+    const vec3_t result = {
+        .x = a.x - b.x,
+        .y = a.y - b.y,
+        .z = a.z - b.z
+    };
+
+    return result;
+}
+
+vec3_t vec3_cross(const vec3_t a, const vec3_t b)
+{
+    const vec3_t result = {
+        .x = a.y * b.z - a.z * b.y,
+        .y = a.z * b.x - a.x * b.z,
+        .z = a.x * b.y - a.y * b.x
+    };
+
+    return result;
+}
+
+float vec3_dot(const vec3_t a, const vec3_t b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+vec3_t vec3_normalize(const vec3_t original_vector)
+{
+    const float length = sqrtf(vec3_dot(original_vector, original_vector));
+
+    if (length == 0.0f)
+    {
+        return original_vector;
+    }
+
+    const vec3_t normalized_vector = {
+        .x = original_vector.x / length,
+        .y = original_vector.y / length,
+        .z = original_vector.z / length
+    };
+
+    return normalized_vector;
+}
+
+/**
+ * @brief Snap one screen coordinate to fixed point.
+ */
+static int32_t coordinate_to_fixed(const float coordinate)
+{
+    // Also sends NaN, from points on the camera plane, to the edge of the guard band.
+    const float clamped = (coordinate > -SUBPIXEL_GUARD_BAND) ?
+        ((coordinate < SUBPIXEL_GUARD_BAND) ? coordinate : SUBPIXEL_GUARD_BAND) : -SUBPIXEL_GUARD_BAND;
+
+    return (int32_t)lrintf(clamped * SUBPIXEL_ONE);
+}
+
+vec2_fixed_t vec2_to_fixed(const vec2_t original_vector)
+{
+    const vec2_fixed_t fixed_vector = {
+        .x = coordinate_to_fixed(original_vector.x),
+        .y = coordinate_to_fixed(original_vector.y)
+    };
+
+    return fixed_vector;
+}
@@ -6,6 +6,26 @@
  * @brief This file contains the definition of the vector types.
  */
 
+#include <stdint.h>
+
+#pragma region Preprocessor directives
+/**
+ * @brief Number of fractional bits of a fixed point screen coordinate, 28.4 gives 1/16 pixel precision.
+ */
+#define SUBPIXEL_BITS 4
+
+/**
+ * @brief One pixel in fixed point screen coordinates.
+ */
+#define SUBPIXEL_ONE (1 << SUBPIXEL_BITS)
+
+/**
+ * @brief Screen coordinates are clamped to this many pixels either side of the origin when they are snapped. Keeps
+ * the products of two coordinate differences, as used by the edge functions, well inside 64 bits.
+ */
+#define SUBPIXEL_GUARD_BAND (1 << 23)
+#pragma endregion
+
 /**
  * @brief A 2D vector.
  */
@@ -21,6 +41,21 @@ typedef struct
     float y;
 } vec2_t;
 
+/**
+ * @brief A 2D screen position in 28.4 fixed point.
+ */
+typedef struct
+{
+    /**
+     * @brief The x component in 1/SUBPIXEL_ONE pixels.
+     */
+    int32_t x;
+    /**
+     * @brief The y component in 1/SUBPIXEL_ONE pixels.
+     */
+    int32_t y;
+} vec2_fixed_t;
+
 /**
  * @brief A 3D vector.
  */
@@ -64,4 +99,53 @@ vec3_t vec3_rotate_y(const vec3_t original_vector, const float angle);
  */
 vec3_t vec3_rotate_z(const vec3_t original_vector, const float angle);
 
+/**
+ * @brief Subtract one 3D vector from another.
+ * @param a The vector to subtract from.
+ * @param b The vector to subtract.
+ * @return The vector a - b.
+ */
+vec3_t vec3_sub(const vec3_t a, const vec3_t b);
+
+/**
+ * @brief Compute the cross product of two 3D vectors.
+ * @param a The left hand side vector.
+ * @param b The right hand side vector.
+ * @return A vector perpendicular to both a and b.
+ */
+vec3_t vec3_cross(const vec3_t a, const vec3_t b);
+
+/**
+ * @brief Compute the dot product of two 3D vectors.
+ * @param a The left hand side vector.
+ * @param b The right hand side vector.
+ * @return The dot product of a and b.
+ */
+float vec3_dot(const vec3_t a, const vec3_t b);
+
+/**
+ * @brief Scale a 3D vector to unit length.
+ * @param original_vector The vector to normalize.
+ * @return The normalized vector, or the original vector if it has zero length.
+ */
+vec3_t vec3_normalize(const vec3_t original_vector);
+
+/**
+ * @brief Snap a screen position to the nearest 28.4 fixed point position, clamped to the guard band.
+ * @param original_vector The screen position in pixels.
+ * @return The snapped position.
+ */
+vec2_fixed_t vec2_to_fixed(const vec2_t original_vector);
+
+/**
+ * @brief Round a fixed point coordinate to the nearest whole pixel.
+ * @param coordinate A coordinate in 1/SUBPIXEL_ONE pixels.
+ * @return The pixel coordinate.
+ */
+static inline int32_t fixed_to_pixel(const int32_t coordinate)
+{
+    // Arithmetic shift, so this rounds half up for negative coordinates too.
+    return (coordinate + (SUBPIXEL_ONE / 2)) >> SUBPIXEL_BITS;
+}
+
 #endif